@@ -38,6 +38,7 @@ class SakuraThread;
 class InitialValidator;
 class HanamiMessaging;
 class ValueItemMap;
+class JsonInputParser;
 
 //--------------------------------------------------------------------------------------------------
 
@@ -149,6 +150,7 @@ private:
     friend SakuraThread;
     friend InitialValidator;
     friend HanamiMessaging;
+    friend JsonInputParser;
 
     std::map<std::string, FieldDef> m_inputValidationMap;
     std::map<std::string, FieldDef> m_outputValidationMap;
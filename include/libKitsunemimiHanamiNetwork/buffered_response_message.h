@@ -0,0 +1,72 @@
+/**
+ * @file        buffered_response_message.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_NETWORK_BUFFERED_RESPONSE_MESSAGE_H
+#define KITSUNEMIMI_HANAMI_NETWORK_BUFFERED_RESPONSE_MESSAGE_H
+
+#include <string>
+#include <string_view>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+namespace Kitsunemimi
+{
+struct DataBuffer;
+
+namespace Hanami
+{
+class HanamiMessagingClient;
+
+/**
+ * @brief response-message, which holds the received data-buffer and gives access to the content
+ *        without copying it into a separate string
+ */
+class BufferedResponseMessage
+{
+public:
+    BufferedResponseMessage();
+    ~BufferedResponseMessage();
+
+    bool success = false;
+    HttpResponseTypes type = OK_RTYPE;
+
+    std::string_view getContent() const;
+    const char* getContentData() const;
+    uint64_t getContentSize() const;
+
+    void reset();
+
+private:
+    friend HanamiMessagingClient;
+
+    DataBuffer* m_buffer = nullptr;
+    const char* m_content = nullptr;
+    uint64_t m_contentSize = 0;
+
+    BufferedResponseMessage(const BufferedResponseMessage &other) = delete;
+    BufferedResponseMessage &operator=(const BufferedResponseMessage &other) = delete;
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_HANAMI_NETWORK_BUFFERED_RESPONSE_MESSAGE_H
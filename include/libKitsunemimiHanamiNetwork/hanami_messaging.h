@@ -26,6 +26,7 @@
 #include <iostream>
 #include <map>
 #include <vector>
+#include <memory>
 #include <regex>
 
 #include <libKitsunemimiHanamiCommon/enums.h>
@@ -48,6 +49,16 @@ namespace Hanami
 class Blossom;
 class HanamiMessagingClient;
 
+enum GenericHandlerPolicy
+{
+    // call handler directly within the thread, which received the message
+    GENERIC_HANDLER_INLINE = 0,
+    // call handler within one of the worker-threads, which also process the triggers
+    GENERIC_HANDLER_DISPATCH_POOL = 1,
+    // call handler within an own thread for the sub-type, which keeps the order of the messages
+    GENERIC_HANDLER_DEDICATED_LANE = 2,
+};
+
 class HanamiMessaging
 {
 
@@ -102,9 +113,24 @@ public:
                      const std::string &group,
                      const std::string &name);
 
+    // generic messages
+    bool addGenericHandler(const uint32_t subType,
+                           void (*handler)(Sakura::Session*,
+                                           const uint32_t,
+                                           void*,
+                                           const uint64_t,
+                                           const uint64_t),
+                           const GenericHandlerPolicy policy = GENERIC_HANDLER_INLINE);
+
+    // streams
+    bool multicastStreamMessage(const std::vector<std::string> &clientIds,
+                                const std::shared_ptr<DataBuffer> &data,
+                                ErrorContainer &error);
+
     HanamiMessagingClient* createTemporaryClient(const std::string &remoteIdentifier,
                                                  const std::string &target,
                                                  ErrorContainer &error);
+    void releaseTemporaryClient(HanamiMessagingClient* client);
     bool closeClient(const std::string &remoteIdentifier,
                      ErrorContainer &error);
 
@@ -113,6 +139,15 @@ public:
 
     void sendGenericErrorMessage(const std::string &errorMessage);
 
+    // metrics
+    uint64_t getNumberOfRejectedTokenCacheHits() const;
+    uint64_t getNumberOfRejectedTokenCacheMisses() const;
+    uint32_t getConcurrencyLimit() const;
+    uint64_t getTriggerQueueWait() const;
+    uint64_t getNumberOfDroppedErrorMessages() const;
+    uint64_t getNumberOfSuppressedErrorMessages() const;
+    uint64_t getNumberOfReusedTemporaryClients() const;
+
     static Kitsunemimi::Sakura::SessionController* m_sessionController;
 
     HanamiMessagingClient* misakiClient = nullptr;
@@ -143,11 +178,14 @@ public:
 
     std::map<std::string, std::map<HttpRequestType, EndpointEntry>> endpointRules;
 
+    // true to parse incoming json-payloads with the simd-based JsonInputParser
+    // instead of the generic JsonItem-parser
+    bool useFastJsonParser = true;
+
 private:
     HanamiMessaging();
 
     bool m_isInit = false;
-    bool m_whileSendError = false;
 
     // session-handling
     std::map<std::string, HanamiMessagingClient*> m_clients;
@@ -156,6 +194,7 @@ private:
     std::mutex m_incominglock;
 
     void fillSupportOverview();
+    void registerMessagingConfigs(ErrorContainer &error);
     bool initClients(const std::vector<std::string> &configGroups,
                      ErrorContainer &error);
 
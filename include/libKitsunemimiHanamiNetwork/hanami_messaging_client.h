@@ -5,7 +5,7 @@
 #include <map>
 #include <vector>
 #include <mutex>
-#include <regex>
+#include <atomic>
 
 #include <libKitsunemimiHanamiCommon/enums.h>
 #include <libKitsunemimiHanamiCommon/structs.h>
@@ -13,6 +13,9 @@
 #include <libKitsunemimiCommon/logger.h>
 #include <libKitsunemimiCommon/threading/thread.h>
 
+#include <libKitsunemimiHanamiNetwork/buffered_response_message.h>
+#include <libKitsunemimiHanamiNetwork/network_address.h>
+
 namespace Kitsunemimi
 {
 struct DataBuffer;
@@ -26,6 +29,18 @@ namespace Hanami
 {
 class ClientHandler;
 class HanamiMessaging;
+class ErrorLogShipper;
+struct StreamCredits;
+class StreamCoalescer;
+class SharedMemoryRing;
+class TemporaryClientPool;
+
+enum StreamSendResult
+{
+    STREAM_SEND_OK = 0,
+    STREAM_SEND_WOULD_BLOCK = 1,
+    STREAM_SEND_FAILED = 2,
+};
 
 class HanamiMessagingClient
         : public Kitsunemimi::Thread
@@ -37,6 +52,15 @@ public:
                            const uint64_t dataSize,
                            const bool replyExpected,
                            ErrorContainer &error);
+    StreamSendResult trySendStreamMessage(const void* data,
+                                          const uint64_t dataSize,
+                                          const bool replyExpected,
+                                          ErrorContainer &error);
+    bool enableStreamFlowControl(const uint64_t windowSize,
+                                 ErrorContainer &error);
+    bool enableStreamCoalescing(const uint64_t maxFrameSize,
+                                const uint32_t maxDelay,
+                                ErrorContainer &error);
 
     bool sendGenericMessage(const uint32_t subType,
                             const void* data,
@@ -50,7 +74,12 @@ public:
 
     bool triggerSakuraFile(ResponseMessage &response,
                            const RequestMessage &request,
-                           ErrorContainer &error);
+                           ErrorContainer &error,
+                           const std::string &token = "");
+    bool triggerSakuraFile(BufferedResponseMessage &response,
+                           const RequestMessage &request,
+                           ErrorContainer &error,
+                           const std::string &token = "");
 
     bool setStreamCallback(void* receiver,
                            void (*processStream)(void*,
@@ -66,29 +95,70 @@ protected:
 private:
     friend ClientHandler;
     friend HanamiMessaging;
+    friend ErrorLogShipper;
+    friend StreamCoalescer;
+    friend TemporaryClientPool;
 
     HanamiMessagingClient(const std::string &remoteIdentifier,
                           const std::string &address,
-                          const uint16_t port);
+                          const uint16_t port,
+                          const std::string &udsPath = "");
     ~HanamiMessagingClient();
 
+    bool sendGenericFrames(const void* frames,
+                           const uint64_t framesSize,
+                           ErrorContainer &error);
+
 
     std::string m_remoteIdentifier = "";
     std::string m_address = "";
+    NetworkAddress m_networkAddress;
     uint16_t m_port = 0;
+    std::string m_udsPath = "";
+    // key for the pool of idle clients, which is only set for temporary clients
+    std::string m_temporaryClientKey = "";
     Sakura::Session* m_session = nullptr;
+    // set, if the session had an error or was closed, so the client is not pooled anymore
+    std::atomic<bool> m_sessionBroken{false};
     std::mutex m_sessionLock;
-
-    void replaceSession(Sakura::Session* newSession);
+    // serialize the stream-messages, because the ring-buffer of the shared memory allows only one
+    // writer, and is hold instead of the session-lock, while waiting for the reader of the ring
+    std::mutex m_streamLock;
+    StreamCredits* m_streamCredits = nullptr;
+    StreamCoalescer* m_streamCoalescer = nullptr;
+    SharedMemoryRing* m_sharedMemoryRing = nullptr;
+
+    void replaceSession(Sakura::Session* newSession,
+                        const bool sameHost = false);
+    void closeSharedMemoryRing();
+    bool closeSession(ErrorContainer &error);
+    bool sendStreamFlowControlRequest(Sakura::Session* session,
+                                      ErrorContainer &error);
+    bool sendStreamCoalescingRequest(Sakura::Session* session,
+                                     ErrorContainer &error);
+    StreamSendResult sendOrCoalesceStreamData(const void* data,
+                                              const uint64_t dataSize,
+                                              const bool replyExpected,
+                                              const bool wait,
+                                              ErrorContainer &error);
+    StreamSendResult sendStreamData(const void* data,
+                                    const uint64_t dataSize,
+                                    const bool replyExpected,
+                                    const bool wait,
+                                    ErrorContainer &error);
     bool waitForAllConnected(const uint32_t timeout);
+    bool useUnixDomainSocket() const;
 
-    bool createRequest(Kitsunemimi::Sakura::Session* session,
-                       ResponseMessage& response,
-                       const RequestMessage &request,
-                       ErrorContainer &error);
+    DataBuffer* createRequest(Kitsunemimi::Sakura::Session* session,
+                              const RequestMessage &request,
+                              const std::string &token,
+                              ErrorContainer &error);
     bool processResponse(ResponseMessage& response,
                          const DataBuffer* responseData,
                          ErrorContainer &error);
+    bool processResponse(BufferedResponseMessage& response,
+                         DataBuffer* responseData,
+                         ErrorContainer &error);
 };
 
 }  // namespace Hanami
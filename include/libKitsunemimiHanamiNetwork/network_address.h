@@ -0,0 +1,63 @@
+/**
+ * @file        network_address.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KITSUNEMIMI_HANAMI_NETWORK_NETWORK_ADDRESS_H
+#define KITSUNEMIMI_HANAMI_NETWORK_NETWORK_ADDRESS_H
+
+#include <string>
+#include <stdint.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+enum NetworkAddressType
+{
+    INVALID_ADDRESS = 0,
+    IPV4_ADDRESS = 1,
+    IPV6_ADDRESS = 2,
+    UDS_ADDRESS = 3,
+};
+
+/**
+ * @brief address of a server or client, which is classified once, when it is read from the
+ *        config, instead of for each new connection
+ */
+struct NetworkAddress
+{
+    NetworkAddressType type = INVALID_ADDRESS;
+    // ip-address without brackets or path of the unix-domain-socket
+    std::string address = "";
+    // binary ip-address in network byte order, where ipv4 only uses the first 4 bytes
+    uint8_t ip[16] = {0};
+
+    bool isTcp() const;
+};
+
+NetworkAddress parseNetworkAddress(const std::string &address);
+bool isLocalAddress(const NetworkAddress &address);
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // KITSUNEMIMI_HANAMI_NETWORK_NETWORK_ADDRESS_H
@@ -0,0 +1,100 @@
+/**
+ * @file        buffered_response_message.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiHanamiNetwork/buffered_response_message.h>
+
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ */
+BufferedResponseMessage::BufferedResponseMessage() {}
+
+/**
+ * @brief destructor
+ */
+BufferedResponseMessage::~BufferedResponseMessage()
+{
+    reset();
+}
+
+/**
+ * @brief get content of the response
+ *
+ * @return view on the content, which is only valid as long as the response-object exist
+ */
+std::string_view
+BufferedResponseMessage::getContent() const
+{
+    if(m_content == nullptr) {
+        return std::string_view();
+    }
+
+    return std::string_view(m_content, m_contentSize);
+}
+
+/**
+ * @brief get pointer to the content of the response
+ *
+ * @return pointer to the content, which is only valid as long as the response-object exist
+ */
+const char*
+BufferedResponseMessage::getContentData() const
+{
+    return m_content;
+}
+
+/**
+ * @brief get size of the content of the response
+ *
+ * @return size of the content in bytes
+ */
+uint64_t
+BufferedResponseMessage::getContentSize() const
+{
+    return m_contentSize;
+}
+
+/**
+ * @brief delete the held data-buffer and reset the object for the next request
+ */
+void
+BufferedResponseMessage::reset()
+{
+    if(m_buffer != nullptr) {
+        delete m_buffer;
+    }
+
+    m_buffer = nullptr;
+    m_content = nullptr;
+    m_contentSize = 0;
+    success = false;
+    type = OK_RTYPE;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
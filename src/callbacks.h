@@ -26,6 +26,12 @@
 #include <message_handling/messaging_event.h>
 #include <message_handling/message_definitions.h>
 #include <message_handling/messaging_event_queue.h>
+#include <message_handling/messaging_event_pool.h>
+#include <message_handling/generic_message_dispatcher.h>
+#include <message_handling/stream_offload_queue.h>
+#include <message_handling/stream_flow_control.h>
+#include <message_handling/shared_memory_transport.h>
+#include <message_handling/temporary_client_pool.h>
 
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
 
@@ -64,42 +70,114 @@ standaloneDataCallback(void*,
     const uint8_t type = static_cast<const uint8_t*>(data->data)[0];
 
     //==============================================================================================
-    if(type == SAKURA_TRIGGER_MESSAGE)
+    if(type == SAKURA_TRIGGER_MESSAGE
+            || type == SAKURA_TOKEN_TRIGGER_MESSAGE)
     {
-        // prepare message
-        const SakuraTriggerHeader* header = static_cast<const SakuraTriggerHeader*>(data->data);
-        const char* message = static_cast<const char*>(data->data);
+        // both headers begin with the same fields, only the token-header appends the token-size
+        uint64_t headerSize = sizeof(SakuraTriggerHeader);
+        uint64_t tokenSize = 0;
+        if(type == SAKURA_TOKEN_TRIGGER_MESSAGE) {
+            headerSize = sizeof(SakuraTokenTriggerHeader);
+        }
+        if(data->usedBufferSize < headerSize)
+        {
+            LOG_WARNING("received broken trigger-message");
+            delete data;
+            return;
+        }
 
-        // get id
-        uint32_t pos = sizeof (SakuraTriggerHeader);
-        const std::string id(&message[pos], header->idSize);
+        const SakuraTriggerHeader* header = static_cast<const SakuraTriggerHeader*>(data->data);
+        if(type == SAKURA_TOKEN_TRIGGER_MESSAGE) {
+            tokenSize = static_cast<const SakuraTokenTriggerHeader*>(data->data)->tokenSize;
+        }
 
-        // get input-values
-        pos += header->idSize;
-        const std::string inputValues(&message[pos], header->inputValuesSize);
+        // check sizes of the peer in 64-bit, before anything is taken from the pool
+        const uint64_t messageSize = headerSize
+                                     + static_cast<uint64_t>(header->idSize)
+                                     + tokenSize
+                                     + static_cast<uint64_t>(header->inputValuesSize);
+        if(messageSize > data->usedBufferSize)
+        {
+            LOG_WARNING("received trigger-message with invalid sizes");
+            delete data;
+            return;
+        }
 
-        LOG_DEBUG("receive sakura-trigger-message for id: " + id
-                  + "\n  and input-values: " + inputValues);
+        // prepare message
+        const char* message = static_cast<const char*>(data->data);
+        const uint64_t idPos = headerSize;
+        const uint64_t tokenPos = idPos + header->idSize;
+        const uint64_t inputValuesPos = tokenPos + tokenSize;
 
-        // create new event and place it within the event-queue
-        MessagingEvent* event = new MessagingEvent(header->requestType,
-                                                   id,
-                                                   inputValues,
-                                                   session,
-                                                   blockerId);
+        // fill recycled event and place it within the event-queue
+        MessagingEvent* event = MessagingEventPool::getInstance()->getEvent();
+        event->initEvent(header->requestType,
+                         &message[idPos],
+                         header->idSize,
+                         &message[tokenPos],
+                         static_cast<uint32_t>(tokenSize),
+                         &message[inputValuesPos],
+                         header->inputValuesSize,
+                         session,
+                         blockerId);
 
-        MessagingEventQueue::getInstance()->addEventToQueue(event);
+        MessagingEventQueue::getInstance()->addTriggerToQueue(event);
     }
     //==============================================================================================
     if(type == SAKURA_GENERIC_MESSAGE)
     {
-        const SakuraGenericHeader* header = static_cast<const SakuraGenericHeader*>(data->data);
-        char* msgBody = &static_cast<char*>(data->data)[sizeof(SakuraGenericHeader)];
-        HanamiMessaging::getInstance()->processGenericRequest(session,
-                                                              header->subType,
-                                                              msgBody,
-                                                              header->size,
-                                                              blockerId);
+        // a message can contain multiple generic messages, for example the batched
+        // error-messages for shiori, so process them one after another
+        GenericMessageDispatcher* dispatcher = GenericMessageDispatcher::getInstance();
+        uint8_t* message = static_cast<uint8_t*>(data->data);
+        uint64_t pos = 0;
+        while(pos + sizeof(SakuraGenericHeader) <= data->usedBufferSize)
+        {
+            const SakuraGenericHeader* header =
+                    reinterpret_cast<const SakuraGenericHeader*>(&message[pos]);
+            const uint64_t bodyPos = pos + sizeof(SakuraGenericHeader);
+            if(header->type != SAKURA_GENERIC_MESSAGE
+                    || bodyPos + header->size > data->usedBufferSize)
+            {
+                LOG_WARNING("received broken generic message");
+                break;
+            }
+
+            // use the generic callback for all sub-types without registered handler
+            const bool dispatched = dispatcher->dispatch(session,
+                                                         header->subType,
+                                                         &message[bodyPos],
+                                                         header->size,
+                                                         blockerId);
+            if(dispatched == false)
+            {
+                HanamiMessaging::getInstance()->processGenericRequest(session,
+                                                                      header->subType,
+                                                                      &message[bodyPos],
+                                                                      header->size,
+                                                                      blockerId);
+            }
+            pos += getGenericFrameSize(header->size);
+        }
+    }
+    //==============================================================================================
+    if(type == SAKURA_STREAM_CREDIT_MESSAGE
+            && data->usedBufferSize >= sizeof(StreamCreditHeader))
+    {
+        const StreamCreditHeader* header = static_cast<const StreamCreditHeader*>(data->data);
+        if(header->enable) {
+            enableStreamCreditGrants(session, header->credits);
+        } else {
+            addStreamCredits(session, header->credits);
+        }
+    }
+    //==============================================================================================
+    if(type == SAKURA_STREAM_COALESCING_MESSAGE) {
+        enableStreamRecordSplitting(session);
+    }
+    //==============================================================================================
+    if(type == SAKURA_SHARED_MEMORY_MESSAGE) {
+        acceptSharedMemoryRing(session, data->data, data->usedBufferSize, blockerId);
     }
     //==============================================================================================
     // TODO: error when unknown
@@ -123,9 +201,13 @@ errorCallback(Sakura::Session* session,
     error.addMeesage("try to close session after error with identifier: '" + identifier + "'");
 
     // close-session
-    if(session->isClientSide()) {
+    if(session->isClientSide())
+    {
+        TemporaryClientPool::getInstance()->markSessionBroken(session);
         HanamiMessaging::getInstance()->closeClient(identifier, error);
-    } else {
+    }
+    else
+    {
         HanamiMessaging::getInstance()->removeInternalClient(identifier);
     }
 
@@ -144,8 +226,16 @@ sessionCreateCallback(Kitsunemimi::Sakura::Session* session,
 {
     // set callback for incoming standalone-messages for trigger sakura-files
     session->setRequestCallback(nullptr, &standaloneDataCallback);
-    session->setStreamCallback(HanamiMessaging::getInstance()->streamReceiver,
-                               HanamiMessaging::getInstance()->processStreamData);
+
+    // set callback for incoming stream-messages, which are given to a queue with own thread,
+    // if enabled, so a slow processing doesn't block the receive-thread
+    HanamiMessaging* messaging = HanamiMessaging::getInstance();
+    if(addStreamOffloadQueue(session,
+                             messaging->streamReceiver,
+                             messaging->processStreamData) == false)
+    {
+        setSessionStreamCallback(session, messaging->streamReceiver, messaging->processStreamData);
+    }
 
     // callback was triggered on server-side, place new session into central list
     if(session->isClientSide() == false) {
@@ -165,8 +255,17 @@ sessionCloseCallback(Kitsunemimi::Sakura::Session* session,
     Kitsunemimi::ErrorContainer error;
     LOG_INFO("try to close session with identifier: '" + identifier + "'");
 
+    // stop reading the shared memory before the queue and callback of the session are removed
+    removeSharedMemoryReader(session);
+    removeStreamOffloadQueue(session);
+
+    // drop deferred generic messages of the session and wait for running handler
+    GenericMessageDispatcher::getInstance()->removeSession(session);
+
     // close-session
-    if(session->isClientSide() == false) {
+    if(session->isClientSide()) {
+        TemporaryClientPool::getInstance()->markSessionBroken(session);
+    } else {
         HanamiMessaging::getInstance()->removeInternalClient(identifier);
     }
 }
@@ -23,6 +23,16 @@
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
 #include <callbacks.h>
 #include <items/item_methods.h>
+#include <message_handling/messaging_event_queue.h>
+#include <message_handling/permission.h>
+#include <message_handling/rate_limiter.h>
+#include <message_handling/concurrency_limiter.h>
+#include <message_handling/error_log_shipper.h>
+#include <message_handling/generic_message_dispatcher.h>
+#include <message_handling/stream_offload_queue.h>
+#include <message_handling/shared_memory_transport.h>
+#include <message_handling/stream_multicast.h>
+#include <message_handling/temporary_client_pool.h>
 
 #include <libKitsunemimiSakuraNetwork/session.h>
 #include <libKitsunemimiSakuraNetwork/session_controller.h>
@@ -31,6 +41,7 @@
 #include <libKitsunemimiHanamiCommon/component_support.h>
 #include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
 #include <libKitsunemimiHanamiNetwork/blossom.h>
+#include <libKitsunemimiHanamiNetwork/network_address.h>
 
 #include <libKitsunemimiCommon/logger.h>
 #include <libKitsunemimiCommon/files/text_file.h>
@@ -39,9 +50,6 @@
 #include <libKitsunemimiCrypto/common.h>
 #include <libKitsunemimiJwt/jwt.h>
 
-#include <../../libKitsunemimiHanamiMessages/protobuffers/shiori_messages.proto3.pb.h>
-#include <../../libKitsunemimiHanamiMessages/message_sub_types.h>
-
 namespace Kitsunemimi
 {
 namespace Hanami
@@ -64,7 +72,10 @@ HanamiMessaging::HanamiMessaging()
 /**
  * @brief destructor
  */
-HanamiMessaging::~HanamiMessaging() {}
+HanamiMessaging::~HanamiMessaging()
+{
+    GenericMessageDispatcher::getInstance()->stopLanes();
+}
 
 /**
  * @brief callback, which is triggered by error-logs
@@ -107,6 +118,110 @@ HanamiMessaging::fillSupportOverview()
     }
 }
 
+/**
+ * @brief register config-options, which are specific for the messaging
+ *
+ * @param error reference for error-output
+ */
+void
+HanamiMessaging::registerMessagingConfigs(ErrorContainer &error)
+{
+    REGISTER_INT_CONFIG("DEFAULT", "number_of_worker", error, 4);
+    REGISTER_INT_CONFIG("DEFAULT", "max_number_of_parallel_triggers", error, 16);
+    REGISTER_BOOL_CONFIG("DEFAULT", "use_fast_json_parser", error, true);
+    REGISTER_INT_CONFIG("DEFAULT", "rejected_token_cache_time", error, 10);
+    REGISTER_INT_CONFIG("DEFAULT", "error_log_dedup_window", error, 1000);
+    REGISTER_INT_CONFIG("DEFAULT", "stream_offload_queue_size", error, 0);
+    REGISTER_INT_CONFIG("DEFAULT", "shared_memory_ring_size", error, 4 * 1024 * 1024);
+    REGISTER_INT_CONFIG("DEFAULT", "temporary_client_idle_time", error, 30000);
+    REGISTER_INT_CONFIG("DEFAULT", "temporary_client_pool_size", error, 16);
+    REGISTER_FLOAT_CONFIG("DEFAULT", "user_rate_limit", error, 0.0);
+    REGISTER_INT_CONFIG("DEFAULT", "user_rate_burst", error, 0);
+    REGISTER_FLOAT_CONFIG("DEFAULT", "endpoint_rate_limit", error, 0.0);
+    REGISTER_INT_CONFIG("DEFAULT", "endpoint_rate_burst", error, 0);
+}
+
+/**
+ * @brief get number of requests, which were directly rejected, because their token was
+ *        rejected by misaki a short time ago
+ *
+ * @return number of cache-hits
+ */
+uint64_t
+HanamiMessaging::getNumberOfRejectedTokenCacheHits() const
+{
+    return Kitsunemimi::Hanami::getNumberOfRejectedTokenCacheHits();
+}
+
+/**
+ * @brief get number of permission-checks, where the token was not in the cache of rejected tokens
+ *
+ * @return number of cache-misses
+ */
+uint64_t
+HanamiMessaging::getNumberOfRejectedTokenCacheMisses() const
+{
+    return Kitsunemimi::Hanami::getNumberOfRejectedTokenCacheMisses();
+}
+
+/**
+ * @brief get current limit of triggers, which are processed at the same time. The limit is
+ *        adjusted based on the queue-wait-time and the processing-time of the triggers.
+ *
+ * @return current concurrency-limit
+ */
+uint32_t
+HanamiMessaging::getConcurrencyLimit() const
+{
+    return ConcurrencyLimiter::getInstance()->getLimit();
+}
+
+/**
+ * @brief get average time, which the triggers waited in the queue before they were processed
+ *
+ * @return average queue-wait-time in microseconds
+ */
+uint64_t
+HanamiMessaging::getTriggerQueueWait() const
+{
+    return ConcurrencyLimiter::getInstance()->getQueueWait();
+}
+
+/**
+ * @brief get number of error-messages for shiori, which were dropped, because the buffer of the
+ *        background-shipper was full
+ *
+ * @return number of dropped error-messages
+ */
+uint64_t
+HanamiMessaging::getNumberOfDroppedErrorMessages() const
+{
+    return ErrorLogShipper::getInstance()->getNumberOfDroppedEntries();
+}
+
+/**
+ * @brief get number of error-messages for shiori, which were only counted, because the same
+ *        message was already send within the deduplication-window
+ *
+ * @return number of suppressed error-messages
+ */
+uint64_t
+HanamiMessaging::getNumberOfSuppressedErrorMessages() const
+{
+    return ErrorLogShipper::getInstance()->getNumberOfSuppressedEntries();
+}
+
+/**
+ * @brief get number of temporary clients, which were reused from the pool of idle clients
+ *
+ * @return number of reused clients
+ */
+uint64_t
+HanamiMessaging::getNumberOfReusedTemporaryClients() const
+{
+    return TemporaryClientPool::getInstance()->getNumberOfReusedClients();
+}
+
 /**
  * @brief add new server
  *
@@ -126,8 +241,15 @@ HanamiMessaging::addServer(const std::string &serverAddress,
                            const std::string &keyFilePath)
 {
     // init server based on the type of the address in the config
-    const std::regex ipv4Regex("\\b((25[0-5]|2[0-4][0-9]|[01]?[0-9][0-9]?)(\\.|$)){4}\\b");
-    if(regex_match(serverAddress, ipv4Regex))
+    const NetworkAddress address = parseNetworkAddress(serverAddress);
+    if(address.type == INVALID_ADDRESS)
+    {
+        error.addMeesage("can't initialize server without address");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    if(address.isTcp())
     {
         // create tcp-server
         if(m_sessionController->addTlsTcpServer(port, certFilePath, keyFilePath, error) == 0)
@@ -163,14 +285,24 @@ HanamiMessaging::createTemporaryClient(const std::string &remoteIdentifier,
                                        const std::string &target,
                                        ErrorContainer &error)
 {
+    // reuse the connected session of a released client for the same identifier and target
+    const std::string key = remoteIdentifier + "@" + target;
+    HanamiMessagingClient* pooledClient = TemporaryClientPool::getInstance()->acquireClient(key);
+    if(pooledClient != nullptr) {
+        return pooledClient;
+    }
+
     bool success = false;
     const std::string address = GET_STRING_CONFIG(target, "address", success);
     if(address != "")
     {
         const uint16_t port = static_cast<uint16_t>(GET_INT_CONFIG(target, "port", success));
+        const std::string udsPath = GET_STRING_CONFIG(target, "uds_path", success);
         HanamiMessagingClient* newClient = new HanamiMessagingClient(remoteIdentifier,
                                                                      address,
-                                                                     port);
+                                                                     port,
+                                                                     udsPath);
+        newClient->m_temporaryClientKey = key;
         if(newClient->connectClient(error) == false)
         {
             delete newClient;
@@ -183,6 +315,25 @@ HanamiMessaging::createTemporaryClient(const std::string &remoteIdentifier,
     return nullptr;
 }
 
+/**
+ * @brief give a client, which was created by createTemporaryClient, back. The client is kept
+ *        connected for a while, to be reused by the next call of createTemporaryClient with the
+ *        same identifier and target, or deleted, if the pool is full.
+ *
+ * @param client client to release, which must not be used after this call
+ */
+void
+HanamiMessaging::releaseTemporaryClient(HanamiMessagingClient* client)
+{
+    if(client == nullptr) {
+        return;
+    }
+
+    if(TemporaryClientPool::getInstance()->releaseClient(client) == false) {
+        delete client;
+    }
+}
+
 /**
  * @brief initalize client-connections
  *
@@ -204,7 +355,11 @@ HanamiMessaging::initClients(const std::vector<std::string> &configGroups,
         if(address != "")
         {
             const uint16_t port = static_cast<uint16_t>(GET_INT_CONFIG(groupName, "port", success));
-            HanamiMessagingClient* newClient = new HanamiMessagingClient(groupName, address, port);
+            const std::string udsPath = GET_STRING_CONFIG(groupName, "uds_path", success);
+            HanamiMessagingClient* newClient = new HanamiMessagingClient(groupName,
+                                                                         address,
+                                                                         port,
+                                                                         udsPath);
             newClient->startThread();
             m_clients.emplace(groupName, newClient);
 
@@ -300,6 +455,7 @@ HanamiMessaging::initialize(const std::string &localIdentifier,
 
     // init config-options
     registerBasicConnectionConfigs(configGroups, createServer, error);
+    registerMessagingConfigs(error);
     if(ConfigHandler::m_config->isConfigValid() == false) {
         return false;
     }
@@ -307,11 +463,88 @@ HanamiMessaging::initialize(const std::string &localIdentifier,
     SupportedComponents* support = SupportedComponents::getInstance();
     support->localComponent = localIdentifier;
 
+    // init worker for the processing of incoming trigger-messages
+    bool success = false;
+    const long numberOfWorker = GET_INT_CONFIG("DEFAULT", "number_of_worker", success);
+    long maxTriggers = GET_INT_CONFIG("DEFAULT", "max_number_of_parallel_triggers", success);
+    if(maxTriggers < numberOfWorker) {
+        maxTriggers = numberOfWorker;
+    }
+    MessagingEventQueue* eventQueue = MessagingEventQueue::getInstance();
+    if(numberOfWorker <= 0
+            || eventQueue->initWorker(static_cast<uint32_t>(numberOfWorker),
+                                      static_cast<uint32_t>(maxTriggers)) == false)
+    {
+        error.addMeesage("Failed to initialize '"
+                         + std::to_string(numberOfWorker)
+                         + "' worker-threads for incoming messages.");
+        LOG_ERROR(error);
+        return false;
+    }
+    useFastJsonParser = GET_BOOL_CONFIG("DEFAULT", "use_fast_json_parser", success);
+    const long rejectedTokenCacheTime = GET_INT_CONFIG("DEFAULT",
+                                                       "rejected_token_cache_time",
+                                                       success);
+    if(rejectedTokenCacheTime >= 0) {
+        setRejectedTokenCacheTime(static_cast<uint32_t>(rejectedTokenCacheTime));
+    }
+    const long streamOffloadQueueSize = GET_INT_CONFIG("DEFAULT",
+                                                       "stream_offload_queue_size",
+                                                       success);
+    if(streamOffloadQueueSize >= 0) {
+        setStreamOffloadQueueSize(static_cast<uint32_t>(streamOffloadQueueSize));
+    }
+    const long sharedMemoryRingSize = GET_INT_CONFIG("DEFAULT",
+                                                     "shared_memory_ring_size",
+                                                     success);
+    if(sharedMemoryRingSize >= 0) {
+        setSharedMemoryRingSize(static_cast<uint64_t>(sharedMemoryRingSize));
+    }
+
+    // init pool for idle temporary clients
+    const long temporaryClientIdleTime = GET_INT_CONFIG("DEFAULT",
+                                                        "temporary_client_idle_time",
+                                                        success);
+    const long temporaryClientPoolSize = GET_INT_CONFIG("DEFAULT",
+                                                        "temporary_client_pool_size",
+                                                        success);
+    if(temporaryClientIdleTime >= 0
+            && temporaryClientPoolSize >= 0)
+    {
+        TemporaryClientPool::getInstance()->setLimits(
+                    static_cast<uint32_t>(temporaryClientIdleTime),
+                    static_cast<uint32_t>(temporaryClientPoolSize));
+    }
+    TemporaryClientPool::getInstance()->startThread();
+
+    // init rate-limits for incoming trigger-messages
+    RateLimiter* rateLimiter = RateLimiter::getInstance();
+    const double userRateLimit = GET_FLOAT_CONFIG("DEFAULT", "user_rate_limit", success);
+    const long userRateBurst = GET_INT_CONFIG("DEFAULT", "user_rate_burst", success);
+    const double endpointRateLimit = GET_FLOAT_CONFIG("DEFAULT", "endpoint_rate_limit", success);
+    const long endpointRateBurst = GET_INT_CONFIG("DEFAULT", "endpoint_rate_burst", success);
+    if(userRateBurst >= 0) {
+        rateLimiter->setUserLimit(userRateLimit, static_cast<uint32_t>(userRateBurst));
+    }
+    if(endpointRateBurst >= 0) {
+        rateLimiter->setEndpointLimit(endpointRateLimit, static_cast<uint32_t>(endpointRateBurst));
+    }
+
+    // start background-thread, which sends the error-messages to shiori
+    if(support->support[SHIORI])
+    {
+        ErrorLogShipper* shipper = ErrorLogShipper::getInstance();
+        const long dedupWindow = GET_INT_CONFIG("DEFAULT", "error_log_dedup_window", success);
+        if(dedupWindow >= 0) {
+            shipper->setDeduplicationWindow(static_cast<uint32_t>(dedupWindow));
+        }
+        shipper->startThread();
+    }
+
     // init server if requested
     if(createServer)
     {
         // get server-address from config
-        bool success = false;
         const std::string serverAddress = GET_STRING_CONFIG("DEFAULT", "address", success);
         if(success == false)
         {
@@ -417,48 +650,18 @@ HanamiMessaging::sendGenericErrorMessage(const std::string &errorMessage)
         return;
     }
 
-    // this function is triggered by every error-message in this logger. if an error is in the
-    // following code which sending to shiori, it would result in an infinity-look of this function
-    // and a stackoverflow. So this variable should ensure, that error in this function doesn't
-    // tigger the function in itself again.
-    if(m_whileSendError == true) {
-        return;
-    }
-    m_whileSendError = true;
-
-    // create message
-    HanamiMessagingClient* client = HanamiMessaging::getInstance()->shioriClient;
-    if(client == nullptr) {
-        return;
-    }
-
-    // create binary for send
-    ErrorLog_Message msg;
-    msg.set_errormsg(errorMessage);
-
-    // serialize message
-    const uint64_t msgSize = msg.ByteSizeLong();
-    uint8_t* buffer = new uint8_t[msgSize];
-    if(msg.SerializeToArray(buffer, msgSize) == false)
-    {
-        m_whileSendError = false;
+    // this function is triggered by every error-message in this logger. Errors of the
+    // shipper-thread, which sends the messages to shiori, would be given back to the shipper again
+    // and could result in an endless loop, so they are not send to shiori.
+    if(ErrorLogShipper::isShipperThread()) {
         return;
     }
 
-    // send message
-    Kitsunemimi::ErrorContainer error;
-    const bool ret = client->sendGenericMessage(SHIORI_ERROR_LOG_MESSAGE_TYPE,
-                                                buffer,
-                                                msgSize,
-                                                error);
-    delete[] buffer;
-    if(ret == false)
-    {
-        m_whileSendError = false;
-        return;
-    }
-
-    m_whileSendError = false;
+    // only add the message to the buffer of the shipper, which sends it in the background,
+    // so the thread, which produced the error, is not blocked by the network
+    ErrorLogEntry entry;
+    entry.errorMessage = errorMessage;
+    ErrorLogShipper::getInstance()->addEntry(entry);
 }
 
 /**
@@ -735,8 +938,10 @@ HanamiMessaging::triggerBlossom(DataMap &result,
     }
 
     // TODO: override only with the output-values to avoid unnecessary conflicts
+    // hand the output over to the result without copying, because the blossomIO is deleted
+    // at the end of this function anyway
     result.clear();
-    overrideItems(result, *output, ALL);
+    moveItems(result, *output, ALL);
 
     return true;
 }
@@ -775,6 +980,105 @@ HanamiMessaging::mapEndpoint(EndpointEntry &result,
     return false;
 }
 
+/**
+ * @brief register a handler for a sub-type of incoming generic messages. Messages without
+ *        registered handler for their sub-type are given to the generic callback, which was
+ *        given at the initializing.
+ *
+ * @param subType sub-type of the generic messages, which should be processed by the handler
+ * @param handler handler to process the messages
+ * @param policy defines, if the handler is called within the network-thread, within the
+ *               worker-threads or within a dedicated thread for the sub-type
+ *
+ * @return false, if handler is invalid or a handler for the sub-type is already registered,
+ *         else true
+ */
+bool
+HanamiMessaging::addGenericHandler(const uint32_t subType,
+                                   void (*handler)(Sakura::Session*,
+                                                   const uint32_t,
+                                                   void*,
+                                                   const uint64_t,
+                                                   const uint64_t),
+                                   const GenericHandlerPolicy policy)
+{
+    return GenericMessageDispatcher::getInstance()->addHandler(subType, handler, policy);
+}
+
+/**
+ * @brief send the same stream-message to multiple clients. The clients are processed by the
+ *        calling thread and the worker-threads in parallel and all use the same buffer.
+ *
+ * @param clientIds identifiers of the outgoing or incoming clients to send the message to
+ * @param data buffer with the message to send
+ * @param error reference for error-output
+ *
+ * @return false, if a client doesn't exist or sending to a client failed, else true
+ */
+bool
+HanamiMessaging::multicastStreamMessage(const std::vector<std::string> &clientIds,
+                                        const std::shared_ptr<DataBuffer> &data,
+                                        ErrorContainer &error)
+{
+    if(data == nullptr)
+    {
+        error.addMeesage("No data given for multicast of stream-message");
+        return false;
+    }
+
+    // resolve clients
+    std::shared_ptr<StreamMulticastJob> job = std::make_shared<StreamMulticastJob>();
+    job->data = data;
+    bool success = true;
+    for(const std::string &id : clientIds)
+    {
+        HanamiMessagingClient* client = getOutgoingClient(id);
+        if(client == nullptr) {
+            client = getIncomingClient(id);
+        }
+        if(client == nullptr)
+        {
+            error.addMeesage("Client with identifier '" + id + "' doesn't exist");
+            success = false;
+            continue;
+        }
+
+        job->clients.push_back(client);
+    }
+    if(job->clients.size() == 0) {
+        return success;
+    }
+    job->errorMessages.resize(job->clients.size());
+
+    // let the worker help with sending, while the calling thread also sends
+    MessagingEventQueue* eventQueue = MessagingEventQueue::getInstance();
+    uint64_t numberOfHelper = eventQueue->getNumberOfWorker();
+    if(numberOfHelper > job->clients.size() - 1) {
+        numberOfHelper = job->clients.size() - 1;
+    }
+    for(uint64_t i = 0; i < numberOfHelper; i++) {
+        eventQueue->addEventToQueue(new StreamMulticastEvent(job));
+    }
+
+    processStreamMulticastJob(job.get());
+    waitForStreamMulticastJob(job.get());
+
+    // collect errors
+    for(uint64_t i = 0; i < job->clients.size(); i++)
+    {
+        if(job->errorMessages[i] != "")
+        {
+            error.addMeesage("Failed to send stream-message to client '"
+                             + job->clients[i]->m_remoteIdentifier
+                             + "': "
+                             + job->errorMessages[i]);
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 /**
  * @brief add new custom-endpoint without the parser
  *
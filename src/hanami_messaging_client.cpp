@@ -1,6 +1,12 @@
 #include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
 
 #include <message_handling/message_definitions.h>
+#include <message_handling/stream_offload_queue.h>
+#include <message_handling/stream_flow_control.h>
+#include <message_handling/stream_coalescer.h>
+#include <message_handling/shared_memory_ring.h>
+#include <message_handling/shared_memory_transport.h>
+#include <message_handling/temporary_client_pool.h>
 
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
 #include <libKitsunemimiHanamiCommon/component_support.h>
@@ -10,6 +16,8 @@
 #include <libKitsunemimiSakuraNetwork/session.h>
 #include <libKitsunemimiSakuraNetwork/session_controller.h>
 
+#include <sys/stat.h>
+
 namespace Kitsunemimi
 {
 namespace Hanami
@@ -21,17 +29,22 @@ namespace Hanami
  * @param remoteIdentifier indentifier with the name of the target
  * @param address target-address
  * @param port target-port
+ * @param udsPath optional path to the unix-domain-socket of the target, which is used instead
+ *                of the tcp-connection, if the target is on the same host
  */
 HanamiMessagingClient::HanamiMessagingClient(const std::string &remoteIdentifier,
                                              const std::string &address,
-                                             const uint16_t port)
+                                             const uint16_t port,
+                                             const std::string &udsPath)
     : Kitsunemimi::Thread("HanamiMessagingClient-" + remoteIdentifier)
 {
     std::lock_guard<std::mutex> guard(m_sessionLock);
 
     m_remoteIdentifier = remoteIdentifier;
     m_address = address;
+    m_networkAddress = parseNetworkAddress(address);
     m_port = port;
+    m_udsPath = udsPath;
 }
 
 /**
@@ -39,10 +52,24 @@ HanamiMessagingClient::HanamiMessagingClient(const std::string &remoteIdentifier
  */
 HanamiMessagingClient::~HanamiMessagingClient()
 {
+    // send remaining coalesced stream-messages before closing the session
+    if(m_streamCoalescer != nullptr)
+    {
+        m_streamCoalescer->close();
+        delete m_streamCoalescer;
+    }
+
     ErrorContainer error;
     if(closeClient(error) == false) {
         LOG_ERROR(error);
     }
+    if(m_temporaryClientKey != "") {
+        TemporaryClientPool::getInstance()->removeTemporaryClient(this);
+    }
+
+    if(m_streamCredits != nullptr) {
+        delete m_streamCredits;
+    }
 }
 
 /**
@@ -61,7 +88,8 @@ HanamiMessagingClient::setStreamCallback(void* receiver,
         return false;
     }
 
-    m_session->setStreamCallback(receiver, processStream);
+    // if the session has a queue for stream-messages, the callback is called by its thread
+    setSessionStreamCallback(m_session, receiver, processStream);
     return true;
 }
 
@@ -75,8 +103,24 @@ HanamiMessagingClient::setStreamCallback(void* receiver,
 bool
 HanamiMessagingClient::closeClient(ErrorContainer &error)
 {
+    closeSharedMemoryRing();
+    std::lock_guard<std::mutex> streamGuard(m_streamLock);
     std::lock_guard<std::mutex> guard(m_sessionLock);
 
+    return closeSession(error);
+}
+
+/**
+ * @brief close and delete the session of the client, which must be called with locked
+ *        stream-lock and session-lock
+ *
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::closeSession(ErrorContainer &error)
+{
     if(m_session == nullptr)
     {
         error.addMeesage("Hanami-client is not initialized with a session");
@@ -89,6 +133,24 @@ HanamiMessagingClient::closeClient(ErrorContainer &error)
         return false;
     }
 
+    // release all senders, which wait for credits of the closed session
+    if(m_streamCredits != nullptr)
+    {
+        unregisterStreamCredits(m_session);
+        resetStreamCredits(m_streamCredits, true);
+    }
+
+    if(m_sharedMemoryRing != nullptr)
+    {
+        m_sharedMemoryRing->close();
+        delete m_sharedMemoryRing;
+        m_sharedMemoryRing = nullptr;
+    }
+
+    if(m_temporaryClientKey != "") {
+        TemporaryClientPool::getInstance()->updateSession(this, m_session, nullptr);
+    }
+
     delete m_session;
     m_session = nullptr;
 
@@ -96,7 +158,8 @@ HanamiMessagingClient::closeClient(ErrorContainer &error)
 }
 
 /**
- * @brief send stream-message over a client
+ * @brief send all blocks of a stack-buffer as stream-messages over a client. The sent blocks
+ *        are removed from the stack-buffer and given back to its reserve.
  *
  * @param data stack-buffer to send
  * @param error reference for error-output
@@ -107,24 +170,35 @@ bool
 HanamiMessagingClient::sendStreamMessage(StackBuffer &data,
                                          ErrorContainer &error)
 {
-    std::lock_guard<std::mutex> guard(m_sessionLock);
-
-    if(m_session == nullptr)
+    StreamCoalescer* coalescer = nullptr;
     {
-        error.addMeesage("Hanami-client is not initialized with a session");
-        return false;
+        std::lock_guard<std::mutex> guard(m_sessionLock);
+        coalescer = m_streamCoalescer;
+    }
+
+    // with coalescing the blocks are packed as records into as few messages as possible
+    if(coalescer != nullptr) {
+        return coalescer->addRecords(data, error) == STREAM_SEND_OK;
     }
 
-    // send all data from the stackbuffer
-    for(uint32_t i = 0; i < data.blocks.size(); i++)
+    // without coalescing each block has to be send as its own message, because the receiver
+    // expects a callback for each block
+    while(data.blocks.size() > 0)
     {
         DataBuffer* buf = getFirstElement_StackBuffer(data);
 
         // only the last buffer should have an expected reply
-        const bool expReply = i == data.blocks.size() - 1;
-        if(m_session->sendStreamData(buf->data, buf->usedBufferSize, error, expReply) == false) {
+        const bool expReply = data.blocks.size() == 1;
+        const StreamSendResult ret = sendStreamData(buf->data,
+                                                    buf->usedBufferSize,
+                                                    expReply,
+                                                    true,
+                                                    error);
+        if(ret != STREAM_SEND_OK) {
             return false;
         }
+
+        // give the block back to the reserve of the stack-buffer for reuse
         removeFirst_StackBuffer(data);
     }
 
@@ -146,6 +220,85 @@ HanamiMessagingClient::sendStreamMessage(const void* data,
                                          const uint64_t dataSize,
                                          const bool replyExpected,
                                          ErrorContainer &error)
+{
+    return sendOrCoalesceStreamData(data, dataSize, replyExpected, true, error) == STREAM_SEND_OK;
+}
+
+/**
+ * @brief send stream-message over a client without waiting for credits, if the flow-control
+ *        is enabled
+ *
+ * @param data pointer to the data to send
+ * @param dataSize size of data in bytes to send
+ * @param replyExpected true to expect a reply-message
+ * @param error reference for error-output
+ *
+ * @return STREAM_SEND_WOULD_BLOCK, if the receiver has not granted enough credits,
+ *         STREAM_SEND_FAILED, if sending failed, else STREAM_SEND_OK
+ */
+StreamSendResult
+HanamiMessagingClient::trySendStreamMessage(const void* data,
+                                            const uint64_t dataSize,
+                                            const bool replyExpected,
+                                            ErrorContainer &error)
+{
+    return sendOrCoalesceStreamData(data, dataSize, replyExpected, false, error);
+}
+
+/**
+ * @brief enable credit-based flow-control for the outgoing stream-messages of this client.
+ *        The receiver grants the bytes back, which it has consumed, and if the sent but not
+ *        granted bytes reach the window-size, sending blocks until new credits are granted.
+ *
+ * @param windowSize maximum number of bytes, which are sent but not consumed by the receiver
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::enableStreamFlowControl(const uint64_t windowSize,
+                                               ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    if(m_session == nullptr)
+    {
+        error.addMeesage("Hanami-client is not initialized with a session");
+        return false;
+    }
+
+    if(windowSize == 0)
+    {
+        error.addMeesage("Window-size for the flow-control of stream-messages must be bigger 0");
+        return false;
+    }
+
+    if(m_streamCredits == nullptr) {
+        m_streamCredits = new StreamCredits();
+    }
+    m_streamCredits->windowSize = windowSize;
+    resetStreamCredits(m_streamCredits, false);
+    registerStreamCredits(m_session, m_streamCredits);
+
+    return sendStreamFlowControlRequest(m_session, error);
+}
+
+/**
+ * @brief enable the coalescing of outgoing stream-messages of this client. Small messages are
+ *        collected and send together, when the collected messages reach the maximum size or
+ *        when the first collected message was hold back for the maximum delay. The receiver
+ *        splits them again and calls its callback for each message.
+ *
+ * @param maxFrameSize size in bytes, at which the collected messages are send
+ * @param maxDelay maximum time in microseconds, which a message is hold back
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::enableStreamCoalescing(const uint64_t maxFrameSize,
+                                              const uint32_t maxDelay,
+                                              ErrorContainer &error)
 {
     std::lock_guard<std::mutex> guard(m_sessionLock);
 
@@ -155,7 +308,229 @@ HanamiMessagingClient::sendStreamMessage(const void* data,
         return false;
     }
 
-    return m_session->sendStreamData(data, dataSize, error, replyExpected);
+    if(m_streamCoalescer != nullptr)
+    {
+        error.addMeesage("Coalescing of stream-messages is already enabled");
+        return false;
+    }
+
+    // the receiver has to know about the coalescing, before the first coalesced message arrives
+    if(sendStreamCoalescingRequest(m_session, error) == false) {
+        return false;
+    }
+
+    m_streamCoalescer = new StreamCoalescer(this, maxFrameSize, maxDelay);
+    m_streamCoalescer->startThread();
+
+    return true;
+}
+
+/**
+ * @brief inform the receiver, that the following stream-messages are coalesced
+ *
+ * @param session session to the receiver
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::sendStreamCoalescingRequest(Sakura::Session* session,
+                                                   ErrorContainer &error)
+{
+    StreamCoalescingHeader header;
+    if(session->sendNormalMessage(&header, sizeof(StreamCoalescingHeader), error) == false)
+    {
+        error.addMeesage("Failed to enable coalescing of stream-messages");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief request the receiver to grant credits for the flow-control of stream-messages
+ *
+ * @param session session to the receiver
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::sendStreamFlowControlRequest(Sakura::Session* session,
+                                                    ErrorContainer &error)
+{
+    StreamCreditHeader header;
+    header.enable = true;
+    header.credits = m_streamCredits->windowSize;
+
+    if(session->sendNormalMessage(&header, sizeof(StreamCreditHeader), error) == false)
+    {
+        error.addMeesage("Failed to enable flow-control for stream-messages");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief send stream-message or add it to the collected messages, if coalescing is enabled
+ *
+ * @param data pointer to the data to send
+ * @param dataSize size of data in bytes to send
+ * @param replyExpected true to expect a reply-message
+ * @param wait true to wait until credits are available
+ * @param error reference for error-output
+ *
+ * @return STREAM_SEND_WOULD_BLOCK, if no credits are available and wait is false,
+ *         STREAM_SEND_FAILED, if sending failed, else STREAM_SEND_OK
+ */
+StreamSendResult
+HanamiMessagingClient::sendOrCoalesceStreamData(const void* data,
+                                                const uint64_t dataSize,
+                                                const bool replyExpected,
+                                                const bool wait,
+                                                ErrorContainer &error)
+{
+    StreamCoalescer* coalescer = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_sessionLock);
+        coalescer = m_streamCoalescer;
+    }
+
+    if(coalescer != nullptr) {
+        return coalescer->addRecord(data, dataSize, replyExpected, wait, error);
+    }
+
+    return sendStreamData(data, dataSize, replyExpected, wait, error);
+}
+
+/**
+ * @brief send stream-message and take credits for it, if the flow-control is enabled
+ *
+ * @param data pointer to the data to send
+ * @param dataSize size of data in bytes to send
+ * @param replyExpected true to expect a reply-message
+ * @param wait true to wait until credits are available
+ * @param error reference for error-output
+ *
+ * @return STREAM_SEND_WOULD_BLOCK, if no credits are available and wait is false,
+ *         STREAM_SEND_FAILED, if sending failed, else STREAM_SEND_OK
+ */
+StreamSendResult
+HanamiMessagingClient::sendStreamData(const void* data,
+                                      const uint64_t dataSize,
+                                      const bool replyExpected,
+                                      const bool wait,
+                                      ErrorContainer &error)
+{
+    // take credits without holding the session-lock, so other messages can be send, while
+    // waiting for credits
+    StreamCredits* credits = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_sessionLock);
+        credits = m_streamCredits;
+    }
+    if(credits != nullptr
+            && takeStreamCredits(credits, dataSize, wait) == false)
+    {
+        if(wait == false) {
+            return STREAM_SEND_WOULD_BLOCK;
+        }
+
+        error.addMeesage("Session was closed while waiting for credits of the receiver");
+        return STREAM_SEND_FAILED;
+    }
+
+    std::lock_guard<std::mutex> streamGuard(m_streamLock);
+    SharedMemoryRing* ring = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(m_sessionLock);
+        ring = m_sharedMemoryRing;
+    }
+
+    // with shared memory all stream-messages go over the ring-buffer, except the ones, which are
+    // too big or expect a reply, which are only send after the ring-buffer is empty to keep the
+    // order of the messages. The waits for the reader are done without the session-lock.
+    if(ring != nullptr)
+    {
+        StreamSendResult ret = STREAM_SEND_OK;
+        if(replyExpected == false
+                && dataSize <= ring->getMaxRecordSize())
+        {
+            if(ring->writeRecord(data, dataSize, wait)) {
+                return STREAM_SEND_OK;
+            }
+            ret = STREAM_SEND_FAILED;
+            if(wait == false
+                    && ring->isClosed() == false)
+            {
+                ret = STREAM_SEND_WOULD_BLOCK;
+            }
+        }
+        else if(wait == false
+                && ring->isEmpty() == false)
+        {
+            ret = STREAM_SEND_WOULD_BLOCK;
+        }
+        else if(ring->waitUntilEmpty() == false)
+        {
+            ret = STREAM_SEND_FAILED;
+        }
+
+        if(ret == STREAM_SEND_FAILED)
+        {
+            ring->close();
+            if(ring->isEmpty())
+            {
+                // all records were processed by the reader, so the ring can be removed and the
+                // message is send over the socket without changing the order of the messages
+                std::lock_guard<std::mutex> guard(m_sessionLock);
+                if(m_sharedMemoryRing == ring)
+                {
+                    delete m_sharedMemoryRing;
+                    m_sharedMemoryRing = nullptr;
+                }
+                ret = STREAM_SEND_OK;
+            }
+            else
+            {
+                // records, which are still in the ring, would be overtaken by a message over
+                // the socket, so the session is closed and the client-thread reconnects
+                error.addMeesage("Shared memory for stream-messages was closed or its reader "
+                                 "doesn't process the messages anymore");
+                std::lock_guard<std::mutex> guard(m_sessionLock);
+                if(m_session != nullptr
+                        && closeSession(error) == false)
+                {
+                    LOG_ERROR(error);
+                }
+            }
+        }
+
+        if(ret != STREAM_SEND_OK)
+        {
+            if(credits != nullptr) {
+                returnStreamCredits(credits, dataSize);
+            }
+            return ret;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    if(m_session == nullptr
+            || m_session->sendStreamData(data, dataSize, error, replyExpected) == false)
+    {
+        if(m_session == nullptr) {
+            error.addMeesage("Hanami-client is not initialized with a session");
+        }
+        if(credits != nullptr) {
+            returnStreamCredits(credits, dataSize);
+        }
+        return STREAM_SEND_FAILED;
+    }
+
+    return STREAM_SEND_OK;
 }
 
 /**
@@ -201,6 +576,33 @@ HanamiMessagingClient::sendGenericMessage(const uint32_t subType,
     return ret;
 }
 
+/**
+ * @brief send multiple generic messages, which are already packed together with their headers,
+ *        within one message over the internal messaging
+ *
+ * @param frames pointer to the packed generic messages
+ * @param framesSize size of all packed generic messages
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::sendGenericFrames(const void* frames,
+                                         const uint64_t framesSize,
+                                         ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    // get client
+    if(m_session == nullptr)
+    {
+        error.addMeesage("Hanami-client is not initialized with a session");
+        return false;
+    }
+
+    return m_session->sendNormalMessage(frames, framesSize, error);
+}
+
 /**
  * @brief send a generic message over the internal messaging
  *
@@ -251,13 +653,16 @@ HanamiMessagingClient::sendGenericRequest(const uint32_t subType,
  * @param response reference for the response
  * @param request request-information to identify the target-action on the remote host
  * @param error reference for error-output
+ * @param token optional token, which is send separated from the input-values, so the remote
+ *              host can check the permission before parsing the input-values
  *
  * @return true, if successful, else false
  */
 bool
 HanamiMessagingClient::triggerSakuraFile(ResponseMessage& response,
                                          const RequestMessage &request,
-                                         ErrorContainer &error)
+                                         ErrorContainer &error,
+                                         const std::string &token)
 {
     std::lock_guard<std::mutex> guard(m_sessionLock);
 
@@ -269,7 +674,8 @@ HanamiMessagingClient::triggerSakuraFile(ResponseMessage& response,
     }
 
     // try to send request to target
-    if(createRequest(m_session, response, request, error) == false)
+    DataBuffer* responseData = createRequest(m_session, request, token, error);
+    if(responseData == nullptr)
     {
         response.success = false;
         response.type = INTERNAL_SERVER_ERROR_RTYPE;
@@ -277,19 +683,153 @@ HanamiMessagingClient::triggerSakuraFile(ResponseMessage& response,
         return false;
     }
 
-    return true;
+    const bool ret = processResponse(response, responseData, error);
+    delete responseData;
+
+    return ret;
+}
+
+/**
+ * @brief trigger remote action and keep the received buffer within the response, to avoid
+ *        copying the content of the response
+ *
+ * @param response reference for the response, which takes over the received data-buffer
+ * @param request request-information to identify the target-action on the remote host
+ * @param error reference for error-output
+ * @param token optional token, which is send separated from the input-values, so the remote
+ *              host can check the permission before parsing the input-values
+ *
+ * @return true, if successful, else false
+ */
+bool
+HanamiMessagingClient::triggerSakuraFile(BufferedResponseMessage &response,
+                                         const RequestMessage &request,
+                                         ErrorContainer &error,
+                                         const std::string &token)
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    response.reset();
+
+    // get client
+    if(m_session == nullptr)
+    {
+        error.addMeesage("Hanami-client is not initialized with a session");
+        return false;
+    }
+
+    // try to send request to target
+    DataBuffer* responseData = createRequest(m_session, request, token, error);
+    if(responseData == nullptr)
+    {
+        response.success = false;
+        response.type = INTERNAL_SERVER_ERROR_RTYPE;
+        error.addMeesage("Failed to trigger sakura-file.");
+        return false;
+    }
+
+    return processResponse(response, responseData, error);
 }
 
 /**
  * @brief HanamiMessagingClient::replaceSession
  * @param newSession
+ * @param sameHost true, if the remote side of the new session is on the same host, to try to
+ *                 send the stream-messages over a shared memory
  */
 void
-HanamiMessagingClient::replaceSession(Sakura::Session* newSession)
+HanamiMessagingClient::replaceSession(Sakura::Session* newSession,
+                                      const bool sameHost)
 {
+    closeSharedMemoryRing();
+    std::lock_guard<std::mutex> streamGuard(m_streamLock);
     std::lock_guard<std::mutex> guard(m_sessionLock);
 
+    // temporary clients are known by the pool with their session, even if they are in use
+    if(m_temporaryClientKey != "") {
+        TemporaryClientPool::getInstance()->updateSession(this, m_session, newSession);
+    }
+
     m_session = newSession;
+    m_sessionBroken = false;
+
+    // the ring-buffer belongs to the old session
+    if(m_sharedMemoryRing != nullptr)
+    {
+        m_sharedMemoryRing->close();
+        delete m_sharedMemoryRing;
+        m_sharedMemoryRing = nullptr;
+    }
+
+    // the receiver of the new session has to be informed about coalescing and flow-control again
+    if(m_streamCoalescer != nullptr
+            && newSession != nullptr)
+    {
+        ErrorContainer error;
+        if(sendStreamCoalescingRequest(newSession, error) == false) {
+            LOG_ERROR(error);
+        }
+    }
+    if(m_streamCredits != nullptr
+            && newSession != nullptr)
+    {
+        resetStreamCredits(m_streamCredits, false);
+        registerStreamCredits(newSession, m_streamCredits);
+
+        ErrorContainer error;
+        if(sendStreamFlowControlRequest(newSession, error) == false) {
+            LOG_ERROR(error);
+        }
+    }
+
+    // the offer is send under the stream-lock, so no stream-message can be send over the socket,
+    // while the receiver is switching to the shared memory
+    if(sameHost
+            && newSession != nullptr)
+    {
+        ErrorContainer error;
+        m_sharedMemoryRing = offerSharedMemoryRing(newSession, error);
+        if(m_sharedMemoryRing == nullptr) {
+            LOG_DEBUG("send stream-messages over socket: " + error.toString());
+        }
+    }
+}
+
+/**
+ * @brief close the ring-buffer of the shared memory, which releases a sender, which waits for the
+ *        reader of the ring, so the stream-lock can be taken to delete the ring afterwards
+ */
+void
+HanamiMessagingClient::closeSharedMemoryRing()
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    if(m_sharedMemoryRing != nullptr) {
+        m_sharedMemoryRing->close();
+    }
+}
+
+/**
+ * @brief check if the tcp-target of the client is on the same host and has a unix-domain-socket
+ *        in the config, which can be used instead
+ *
+ * @return true, if the unix-domain-socket should be used, else false
+ */
+bool
+HanamiMessagingClient::useUnixDomainSocket() const
+{
+    if(m_udsPath == "") {
+        return false;
+    }
+
+    struct stat fileStat;
+    if(stat(m_udsPath.c_str(), &fileStat) != 0
+            || S_ISSOCK(fileStat.st_mode) == false)
+    {
+        return false;
+    }
+
+    return isLocalAddress(m_networkAddress);
 }
 
 /**
@@ -315,19 +855,32 @@ HanamiMessagingClient::connectClient(ErrorContainer &error)
         localIdent = m_remoteIdentifier;
     }
 
-    // connect based on the address-type
-    const std::regex ipv4Regex(IPV4_REGEX);
-    if(regex_match(m_address, ipv4Regex))
+    // connect based on the address-type, which was classified in the constructor
+    bool sameHost = false;
+    if(m_networkAddress.isTcp())
     {
-        newSession = sessionCon->startTcpSession(m_address,
-                                                 m_port,
-                                                 localIdent,
-                                                 "HanamiClient",
-                                                 error);
+        // prefer the unix-domain-socket of a local target to avoid tls and the tcp-stack
+        if(useUnixDomainSocket())
+        {
+            newSession = sessionCon->startUnixDomainSession(m_udsPath,
+                                                            localIdent,
+                                                            "HanamiClient",
+                                                            error);
+            sameHost = newSession != nullptr;
+        }
+        if(newSession == nullptr)
+        {
+            newSession = sessionCon->startTcpSession(m_networkAddress.address,
+                                                     m_port,
+                                                     localIdent,
+                                                     "HanamiClient",
+                                                     error);
+        }
     }
-    else
+    else if(m_networkAddress.type == UDS_ADDRESS)
     {
-        newSession = sessionCon->startUnixDomainSession(m_address,
+        sameHost = true;
+        newSession = sessionCon->startUnixDomainSession(m_networkAddress.address,
                                                         localIdent,
                                                         "HanamiClient",
                                                         error);
@@ -342,7 +895,7 @@ HanamiMessagingClient::connectClient(ErrorContainer &error)
 
     // handle result
     newSession->m_sessionIdentifier = m_remoteIdentifier;
-    replaceSession(newSession);
+    replaceSession(newSession, sameHost);
 
     return true;
 }
@@ -441,42 +994,105 @@ HanamiMessagingClient::processResponse(ResponseMessage& response,
 }
 
 /**
- * @brief trigger sakura-file remotely
+ * @brief process response-message and hand the data-buffer over to the response
  *
- * @param result resulting data-items coming from the triggered tree
- * @param id tree-id to trigger
- * @param inputValues input-values as string
- * @param errorMessage reference for error-output
+ * @param response reference for the response, which takes over the data-buffer
+ * @param responseData data-buffer with the plain response message
+ * @param error reference for error-output
  *
- * @return true, if successful, else false
+ * @return false, if message is invalid, else true
  */
 bool
+HanamiMessagingClient::processResponse(BufferedResponseMessage& response,
+                                       DataBuffer* responseData,
+                                       ErrorContainer &error)
+{
+    // buffer is deleted together with the response, also in case of an error
+    response.m_buffer = responseData;
+
+    // precheck
+    if(responseData->usedBufferSize < sizeof(ResponseHeader)
+            || responseData->data == nullptr)
+    {
+        error.addMeesage("missing message-content");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    // reference content within the buffer
+    const ResponseHeader* header = static_cast<const ResponseHeader*>(responseData->data);
+    const char* message = static_cast<const char*>(responseData->data);
+    if(sizeof(ResponseHeader) + header->messageSize > responseData->usedBufferSize)
+    {
+        error.addMeesage("response-message is bigger than the received data");
+        LOG_ERROR(error);
+        return false;
+    }
+
+    response.success = header->success;
+    response.type = header->responseType;
+    response.m_content = &message[sizeof(ResponseHeader)];
+    response.m_contentSize = header->messageSize;
+
+    return true;
+}
+
+/**
+ * @brief trigger sakura-file remotely
+ *
+ * @param session session, over which the request should be send
+ * @param request request-information to identify the target-action on the remote host
+ * @param token token to send within the header of the request, or empty string
+ * @param error reference for error-output
+ *
+ * @return data-buffer with the response, if successful, else nullptr
+ */
+DataBuffer*
 HanamiMessagingClient::createRequest(Kitsunemimi::Sakura::Session* session,
-                                     ResponseMessage& response,
                                      const RequestMessage &request,
+                                     const std::string &token,
                                      ErrorContainer &error)
 {
+    // the token-header is only used with token, so old receivers still understand the trigger
+    const uint64_t headerSize = token.size() > 0 ? sizeof(SakuraTokenTriggerHeader)
+                                                 : sizeof(SakuraTriggerHeader);
+
     // create buffer
-    const uint64_t totalSize = sizeof(SakuraTriggerHeader)
+    const uint64_t totalSize = headerSize
                                + request.id.size()
+                               + token.size()
                                + request.inputValues.size();
     uint8_t* buffer = new uint8_t[totalSize];
     uint32_t positionCounter = 0;
 
-    // prepare header
-    SakuraTriggerHeader header;
-    header.idSize = static_cast<uint32_t>(request.id.size());
-    header.requestType = request.httpType;
-    header.inputValuesSize = static_cast<uint32_t>(request.inputValues.size());
-
-    // copy header
-    memcpy(buffer, &header, sizeof(SakuraTriggerHeader));
-    positionCounter += sizeof(SakuraTriggerHeader);
+    // prepare and copy header
+    if(token.size() > 0)
+    {
+        SakuraTokenTriggerHeader header;
+        header.idSize = static_cast<uint32_t>(request.id.size());
+        header.tokenSize = static_cast<uint32_t>(token.size());
+        header.requestType = request.httpType;
+        header.inputValuesSize = static_cast<uint32_t>(request.inputValues.size());
+        memcpy(buffer, &header, sizeof(SakuraTokenTriggerHeader));
+    }
+    else
+    {
+        SakuraTriggerHeader header;
+        header.idSize = static_cast<uint32_t>(request.id.size());
+        header.requestType = request.httpType;
+        header.inputValuesSize = static_cast<uint32_t>(request.inputValues.size());
+        memcpy(buffer, &header, sizeof(SakuraTriggerHeader));
+    }
+    positionCounter += headerSize;
 
     // copy id
     memcpy(buffer + positionCounter, request.id.c_str(), request.id.size());
     positionCounter += request.id.size();
 
+    // copy token
+    memcpy(buffer + positionCounter, token.c_str(), token.size());
+    positionCounter += token.size();
+
     // copy input-values
     memcpy(buffer + positionCounter, request.inputValues.c_str(), request.inputValues.size());
 
@@ -488,13 +1104,10 @@ HanamiMessagingClient::createRequest(Kitsunemimi::Sakura::Session* session,
     {
         error.addMeesage("Timeout while triggering sakura-file with id: " + request.id);
         LOG_ERROR(error);
-        return false;
+        return nullptr;
     }
 
-    const bool ret = processResponse(response, responseData, error);
-    delete responseData;
-
-    return ret;
+    return responseData;
 }
 
 }  // namespace Hanami
@@ -87,6 +87,60 @@ overrideItems(DataMap &original,
     }
 }
 
+/**
+ * @brief move items of a data-map into another data-map. In contrast to overrideItems, the
+ *        items are not copied, but the pointers are taken from the source-map. Moved items are
+ *        removed from the source-map, while items, which are not moved, stay there.
+ *
+ * @param original data-map with the original key-values, which should be updates with the
+ *                 information of the source-map
+ * @param source map with the new incoming information, which is taken over
+ * @param type type of override
+ */
+void
+moveItems(DataMap &original,
+          DataMap &source,
+          OverrideType type)
+{
+    // if all items are moved into an empty map, the complete content can be swapped
+    if(type == ALL
+            && original.map.size() == 0)
+    {
+        original.map.swap(source.map);
+        return;
+    }
+
+    std::map<std::string, DataItem*>::iterator sourceIt = source.map.begin();
+    while(sourceIt != source.map.end())
+    {
+        std::map<std::string, DataItem*>::iterator originalIt;
+        originalIt = original.map.find(sourceIt->first);
+        const bool exist = originalIt != original.map.end();
+
+        if((type == ONLY_EXISTING && exist == false)
+                || (type == ONLY_NON_EXISTING && exist))
+        {
+            sourceIt++;
+            continue;
+        }
+
+        // replace old item or add new item
+        if(exist)
+        {
+            if(originalIt->second != nullptr) {
+                delete originalIt->second;
+            }
+            originalIt->second = sourceIt->second;
+        }
+        else
+        {
+            original.map.emplace(sourceIt->first, sourceIt->second);
+        }
+
+        sourceIt = source.map.erase(sourceIt);
+    }
+}
+
 /**
  * @brief create an error-output
  *
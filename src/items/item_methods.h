@@ -50,6 +50,9 @@ enum OverrideType
 void overrideItems(DataMap &original,
                    const DataMap &override,
                    OverrideType type);
+void moveItems(DataMap &original,
+               DataMap &source,
+               OverrideType type);
 
 // error-output
 void createError(const BlossomItem &blossomItem,
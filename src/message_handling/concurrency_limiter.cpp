@@ -0,0 +1,244 @@
+/**
+ * @file        concurrency_limiter.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "concurrency_limiter.h"
+
+#include <cmath>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// number of samples, after which the minimal latency is replaced by the minimum of the last window
+const uint32_t MIN_LATENCY_WINDOW = 1000;
+
+// factor, by which the latency can rise above the minimal latency, before the limit shrinks
+const double LATENCY_TOLERANCE = 2.0;
+
+// average queue-wait-time in microseconds, above which the limit is raised
+const double MAX_QUEUE_WAIT = 1000.0;
+
+Kitsunemimi::Hanami::ConcurrencyLimiter* ConcurrencyLimiter::m_instance = nullptr;
+
+/**
+ * @brief constructor
+ */
+ConcurrencyLimiter::ConcurrencyLimiter() {}
+
+/**
+ * @brief get instance of the concurrency-limiter
+ *
+ * @return pointer to the instance of the concurrency-limiter
+ */
+ConcurrencyLimiter*
+ConcurrencyLimiter::getInstance()
+{
+    if(m_instance == nullptr) {
+        m_instance = new ConcurrencyLimiter();
+    }
+
+    return m_instance;
+}
+
+/**
+ * @brief set the range of the limit. The current limit starts at the init-value and can grow up
+ *        to the maximum, when triggers have to wait in the queue.
+ *
+ * @param initLimit initial number of triggers, which are processed at the same time
+ * @param maxLimit maximum number of triggers, which are processed at the same time
+ */
+void
+ConcurrencyLimiter::setLimits(const uint32_t initLimit,
+                              const uint32_t maxLimit)
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+
+    m_maxLimit = maxLimit;
+    if(m_maxLimit == 0) {
+        m_maxLimit = 1;
+    }
+
+    m_limit = static_cast<double>(initLimit);
+    if(m_limit < 1.0) {
+        m_limit = 1.0;
+    }
+    if(m_limit > static_cast<double>(m_maxLimit)) {
+        m_limit = static_cast<double>(m_maxLimit);
+    }
+}
+
+/**
+ * @brief get a slot to process a trigger, without waiting
+ *
+ * @return true, if a slot was assigned, false if all slots are in use
+ */
+bool
+ConcurrencyLimiter::tryAcquireSlot()
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+
+    if(m_activeSlots >= getLimitValue()) {
+        return false;
+    }
+
+    m_activeSlots++;
+    return true;
+}
+
+/**
+ * @brief give back a slot and update the limit with the timings of the processed trigger
+ *
+ * @param queueWait time in microseconds, which the trigger had waited in the queue
+ * @param latency processing-time of the trigger in microseconds
+ */
+void
+ConcurrencyLimiter::releaseSlot(const uint64_t queueWait,
+                                const uint64_t latency)
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+
+    updateLimit(queueWait, latency, m_activeSlots);
+    m_activeSlots--;
+}
+
+/**
+ * @brief get current limit of triggers, which are processed at the same time
+ *
+ * @return current limit
+ */
+uint32_t
+ConcurrencyLimiter::getLimit()
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+    return getLimitValue();
+}
+
+/**
+ * @brief get number of triggers, which are processed at the moment
+ *
+ * @return number of used slots
+ */
+uint32_t
+ConcurrencyLimiter::getNumberOfActiveSlots()
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+    return m_activeSlots;
+}
+
+/**
+ * @brief get average time, which the triggers have waited in the queue
+ *
+ * @return average queue-wait-time in microseconds
+ */
+uint64_t
+ConcurrencyLimiter::getQueueWait()
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+    return static_cast<uint64_t>(m_queueWait);
+}
+
+/**
+ * @brief get current limit as integer, which must be called with locked mutex
+ *
+ * @return current limit
+ */
+uint32_t
+ConcurrencyLimiter::getLimitValue() const
+{
+    return static_cast<uint32_t>(m_limit);
+}
+
+/**
+ * @brief update limit with new samples. The queue-wait-time shows, if more triggers arrive than
+ *        can be processed with the current limit. In this case the limit grows by the square-root
+ *        of the limit. The gradient between the minimal latency and the current latency shows, if
+ *        the triggers start to block each other, so the limit shrinks in relation to the rise of
+ *        the latency, as soon as it is more than twice as high as the minimal latency.
+ *
+ * @param queueWait time in microseconds, which the trigger had waited in the queue
+ * @param latency processing-time of the trigger in microseconds
+ * @param activeSlots number of used slots, while the trigger was processed
+ */
+void
+ConcurrencyLimiter::updateLimit(const uint64_t queueWait,
+                                const uint64_t latency,
+                                const uint32_t activeSlots)
+{
+    const double sample = static_cast<double>(latency) + 1.0;
+
+    // init with first sample
+    if(m_shortLatency == 0.0)
+    {
+        m_shortLatency = sample;
+        m_minLatency = sample;
+        m_windowMinLatency = sample;
+        m_queueWait = static_cast<double>(queueWait);
+        return;
+    }
+
+    m_shortLatency = m_shortLatency * 0.9 + sample * 0.1;
+    m_queueWait = m_queueWait * 0.9 + static_cast<double>(queueWait) * 0.1;
+
+    // renew the minimal latency after each window, if the load-pattern changed permanently
+    if(sample < m_minLatency) {
+        m_minLatency = sample;
+    }
+    if(m_numberOfWindowSamples == 0 || sample < m_windowMinLatency) {
+        m_windowMinLatency = sample;
+    }
+    m_numberOfWindowSamples++;
+    if(m_numberOfWindowSamples >= MIN_LATENCY_WINDOW)
+    {
+        m_minLatency = m_windowMinLatency;
+        m_numberOfWindowSamples = 0;
+    }
+
+    double gradient = (m_minLatency * LATENCY_TOLERANCE) / m_shortLatency;
+    if(gradient < 0.5) {
+        gradient = 0.5;
+    }
+    if(gradient > 1.0) {
+        gradient = 1.0;
+    }
+
+    // only raise the limit, if triggers are waiting and the limit is really used
+    double headroom = 0.0;
+    if(m_queueWait > MAX_QUEUE_WAIT
+            && activeSlots + 1 >= getLimitValue())
+    {
+        headroom = std::sqrt(m_limit);
+    }
+
+    const double newLimit = m_limit * gradient + headroom;
+    m_limit = m_limit * 0.8 + newLimit * 0.2;
+
+    if(m_limit < 1.0) {
+        m_limit = 1.0;
+    }
+    if(m_limit > static_cast<double>(m_maxLimit)) {
+        m_limit = static_cast<double>(m_maxLimit);
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,77 @@
+/**
+ * @file        concurrency_limiter.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef CONCURRENCY_LIMITER_H
+#define CONCURRENCY_LIMITER_H
+
+#include <mutex>
+#include <stdint.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class ConcurrencyLimiter
+{
+public:
+    static ConcurrencyLimiter* getInstance();
+
+    void setLimits(const uint32_t initLimit, const uint32_t maxLimit);
+
+    bool tryAcquireSlot();
+    void releaseSlot(const uint64_t queueWait, const uint64_t latency);
+
+    uint32_t getLimit();
+    uint32_t getNumberOfActiveSlots();
+    uint64_t getQueueWait();
+
+private:
+    ConcurrencyLimiter();
+
+    static ConcurrencyLimiter* m_instance;
+
+    uint32_t m_maxLimit = 1;
+    double m_limit = 1.0;
+    uint32_t m_activeSlots = 0;
+
+    // average of the latency and the queue-wait-time in microseconds
+    double m_shortLatency = 0.0;
+    double m_queueWait = 0.0;
+
+    // minimal latency, which is renewed after each window of samples, to follow changes
+    double m_minLatency = 0.0;
+    double m_windowMinLatency = 0.0;
+    uint32_t m_numberOfWindowSamples = 0;
+
+    std::mutex m_limiterLock;
+
+    uint32_t getLimitValue() const;
+    void updateLimit(const uint64_t queueWait,
+                     const uint64_t latency,
+                     const uint32_t activeSlots);
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // CONCURRENCY_LIMITER_H
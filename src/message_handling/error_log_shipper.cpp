@@ -0,0 +1,467 @@
+/**
+ * @file        error_log_shipper.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "error_log_shipper.h"
+
+#include <message_handling/message_definitions.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiCommon/component_support.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <../../libKitsunemimiHanamiMessages/protobuffers/shiori_messages.proto3.pb.h>
+#include <../../libKitsunemimiHanamiMessages/message_sub_types.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+Kitsunemimi::Hanami::ErrorLogShipper* ErrorLogShipper::m_instance = nullptr;
+
+// number of entries within the ring-buffer, which must be a power of two
+const uint64_t ERROR_LOG_RING_SIZE = 4096;
+
+// limits for the entries, which are send together within one message
+const uint32_t MAX_ENTRIES_PER_FRAME = 256;
+const uint64_t MAX_FRAME_SIZE = 128 * 1024;
+
+// maximum number of different messages, which are deduplicated at the same time
+const uint64_t MAX_DEDUP_ENTRIES = 10000;
+const uint64_t NUMBER_OF_DEDUP_SHARDS = 16;
+
+// set for the shipper-thread, because errors while sending to shiori would be given back to the
+// shipper by the error-callback again and could result in an endless loop
+thread_local bool t_isShipperThread = false;
+
+/**
+ * @brief constructor
+ */
+ErrorLogShipper::ErrorLogShipper()
+    : Kitsunemimi::Thread("ErrorLogShipper")
+{
+    m_ring = new RingSlot[ERROR_LOG_RING_SIZE];
+    m_ringMask = ERROR_LOG_RING_SIZE - 1;
+    for(uint64_t i = 0; i < ERROR_LOG_RING_SIZE; i++) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_dedupShards = new DedupShard[NUMBER_OF_DEDUP_SHARDS];
+    m_frame.reserve(MAX_FRAME_SIZE);
+}
+
+/**
+ * @brief get instance of the error-log-shipper
+ *
+ * @return pointer to the instance of the error-log-shipper
+ */
+ErrorLogShipper*
+ErrorLogShipper::getInstance()
+{
+    if(m_instance == nullptr) {
+        m_instance = new ErrorLogShipper();
+    }
+
+    return m_instance;
+}
+
+/**
+ * @brief add new entry to the ring-buffer without blocking. If the same message was already
+ *        added within the deduplication-window, it is only counted. If the ring-buffer is full,
+ *        the new entry is dropped, so older entries, which describe the begin of a problem,
+ *        are kept.
+ *
+ * @param entry entry to add, which content is moved into the ring-buffer
+ *
+ * @return false, if the ring-buffer is full and the entry was dropped, else true
+ */
+bool
+ErrorLogShipper::addEntry(ErrorLogEntry &entry)
+{
+    DedupEntry expiredEntry;
+    if(isDuplicate(entry, expiredEntry)) {
+        return true;
+    }
+
+    // send counter of the expired window directly, before the entry, which starts the new window
+    if(expiredEntry.numberOfSuppressed > 0)
+    {
+        addRepeatCounter(expiredEntry);
+        pushEntry(expiredEntry.duplicate);
+    }
+
+    return pushEntry(entry);
+}
+
+/**
+ * @brief add new entry to the ring-buffer without blocking
+ *
+ * @param entry entry to add, which content is moved into the ring-buffer
+ *
+ * @return false, if the ring-buffer is full and the entry was dropped, else true
+ */
+bool
+ErrorLogShipper::pushEntry(ErrorLogEntry &entry)
+{
+    uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+    while(true)
+    {
+        RingSlot* slot = &m_ring[pos & m_ringMask];
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+
+        if(diff == 0)
+        {
+            // try to reserve the slot
+            if(m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot->entry.userId.swap(entry.userId);
+                slot->entry.context.swap(entry.context);
+                slot->entry.values.swap(entry.values);
+                slot->entry.errorMessage.swap(entry.errorMessage);
+                slot->sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if(diff < 0)
+        {
+            // ring-buffer is full
+            m_droppedEntries.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            // another producer was faster
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief set time-window for the deduplication of error-messages
+ *
+ * @param windowTime time-window in milliseconds. 0 disables the deduplication.
+ */
+void
+ErrorLogShipper::setDeduplicationWindow(const uint32_t windowTime)
+{
+    m_dedupWindow = windowTime;
+}
+
+/**
+ * @brief check if an entry with the same fingerprint was already added within the current
+ *        deduplication-window. The first entry of a window is send directly, all following are
+ *        only counted. If the window is already expired, it is restarted directly by the entry.
+ *
+ * @param entry entry to check
+ * @param expiredEntry reference for the content of an expired window, which was restarted
+ *
+ * @return true, if entry is a duplicate and was counted, else false
+ */
+bool
+ErrorLogShipper::isDuplicate(const ErrorLogEntry &entry,
+                             DedupEntry &expiredEntry)
+{
+    const uint32_t dedupWindow = m_dedupWindow.load(std::memory_order_relaxed);
+    if(dedupWindow == 0) {
+        return false;
+    }
+
+    // the user-id is part of the fingerprint, so errors of different users are not merged
+    const uint64_t fingerprint = std::hash<std::string>{}(entry.errorMessage)
+                                 ^ (std::hash<std::string>{}(entry.userId) * 31);
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    DedupShard* shard = &m_dedupShards[fingerprint % NUMBER_OF_DEDUP_SHARDS];
+    std::lock_guard<std::mutex> guard(shard->lock);
+
+    std::map<uint64_t, DedupEntry>::iterator it = shard->entries.find(fingerprint);
+    if(it != shard->entries.end())
+    {
+        if(it->second.windowEnd > now)
+        {
+            // only the first duplicate is copied, to keep the critical section short, while the
+            // same error is produced in a high frequency
+            if(it->second.numberOfSuppressed == 0) {
+                it->second.duplicate = entry;
+            }
+            it->second.numberOfSuppressed++;
+            m_suppressedEntries.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // restart expired window, so the following duplicates are suppressed again, without
+        // waiting for the shipper-thread
+        if(it->second.numberOfSuppressed > 0)
+        {
+            expiredEntry.numberOfSuppressed = it->second.numberOfSuppressed;
+            expiredEntry.duplicate.userId.swap(it->second.duplicate.userId);
+            expiredEntry.duplicate.context.swap(it->second.duplicate.context);
+            expiredEntry.duplicate.values.swap(it->second.duplicate.values);
+            expiredEntry.duplicate.errorMessage.swap(it->second.duplicate.errorMessage);
+        }
+        it->second.windowEnd = now + std::chrono::milliseconds(dedupWindow);
+        it->second.numberOfSuppressed = 0;
+
+        return false;
+    }
+
+    if(shard->entries.size() >= MAX_DEDUP_ENTRIES / NUMBER_OF_DEDUP_SHARDS) {
+        return false;
+    }
+
+    DedupEntry newEntry;
+    newEntry.windowEnd = now + std::chrono::milliseconds(dedupWindow);
+    shard->entries.insert(std::make_pair(fingerprint, newEntry));
+
+    return false;
+}
+
+/**
+ * @brief append the number of occurrences to the message of an expired deduplication-window
+ *
+ * @param dedupEntry expired deduplication-entry
+ */
+void
+ErrorLogShipper::addRepeatCounter(DedupEntry &dedupEntry)
+{
+    dedupEntry.duplicate.errorMessage += "\n(repeated "
+                                         + std::to_string(dedupEntry.numberOfSuppressed)
+                                         + " times within "
+                                         + std::to_string(m_dedupWindow.load())
+                                         + " ms)";
+}
+
+/**
+ * @brief send all entries with expired deduplication-window, which have suppressed duplicates,
+ *        together with their number of occurrences and remove the expired windows
+ *
+ * @param flushAll true to handle all windows as expired
+ */
+void
+ErrorLogShipper::flushDeduplication(const bool flushAll)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::vector<DedupEntry> expiredEntries;
+
+    // only collect the expired entries under the lock of each shard, to block the producer as
+    // short as possible
+    for(uint64_t i = 0; i < NUMBER_OF_DEDUP_SHARDS; i++)
+    {
+        DedupShard* shard = &m_dedupShards[i];
+        std::lock_guard<std::mutex> guard(shard->lock);
+
+        std::map<uint64_t, DedupEntry>::iterator it = shard->entries.begin();
+        while(it != shard->entries.end())
+        {
+            if(flushAll
+                    || it->second.windowEnd <= now)
+            {
+                if(it->second.numberOfSuppressed > 0) {
+                    expiredEntries.push_back(std::move(it->second));
+                }
+                it = shard->entries.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    for(DedupEntry &dedupEntry : expiredEntries)
+    {
+        addRepeatCounter(dedupEntry);
+        appendToFrame(dedupEntry.duplicate);
+        if(m_frame.size() >= MAX_FRAME_SIZE) {
+            sendFrame();
+        }
+    }
+}
+
+/**
+ * @brief get number of entries, which were not send, because they were duplicates of an
+ *        already send entry and only counted
+ *
+ * @return number of suppressed entries
+ */
+uint64_t
+ErrorLogShipper::getNumberOfSuppressedEntries() const
+{
+    return m_suppressedEntries.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief get number of entries, which were dropped, because the ring-buffer was full
+ *
+ * @return number of dropped entries
+ */
+uint64_t
+ErrorLogShipper::getNumberOfDroppedEntries() const
+{
+    return m_droppedEntries.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief check if the current thread is the shipper-thread
+ *
+ * @return true, if called by the shipper-thread, else false
+ */
+bool
+ErrorLogShipper::isShipperThread()
+{
+    return t_isShipperThread;
+}
+
+/**
+ * @brief get next entry from the ring-buffer, which is only called by the shipper-thread
+ *
+ * @param entry reference for the entry, which takes over the content
+ *
+ * @return false, if ring-buffer is empty, else true
+ */
+bool
+ErrorLogShipper::getEntry(ErrorLogEntry &entry)
+{
+    RingSlot* slot = &m_ring[m_dequeuePos & m_ringMask];
+    const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+    if(static_cast<int64_t>(sequence) - static_cast<int64_t>(m_dequeuePos + 1) < 0) {
+        return false;
+    }
+
+    // swap, so the strings of the slot keep the memory of the entry for the next round
+    entry.userId.swap(slot->entry.userId);
+    entry.context.swap(slot->entry.context);
+    entry.values.swap(slot->entry.values);
+    entry.errorMessage.swap(slot->entry.errorMessage);
+
+    slot->sequence.store(m_dequeuePos + m_ringMask + 1, std::memory_order_release);
+    m_dequeuePos++;
+
+    return true;
+}
+
+/**
+ * @brief serialize entry and append it as generic message to the frame
+ *
+ * @param entry entry to append
+ */
+void
+ErrorLogShipper::appendToFrame(const ErrorLogEntry &entry)
+{
+    ErrorLog_Message msg;
+    msg.set_userid(entry.userId);
+    msg.set_context(entry.context);
+    msg.set_values(entry.values);
+    msg.set_component(SupportedComponents::getInstance()->localComponent);
+    msg.set_errormsg(entry.errorMessage);
+
+    const uint64_t msgSize = msg.ByteSizeLong();
+    const uint64_t framePos = m_frame.size();
+    const uint64_t subFrameSize = getGenericFrameSize(msgSize);
+    m_frame.resize(framePos + subFrameSize, 0);
+
+    SakuraGenericHeader header;
+    header.subType = SHIORI_ERROR_LOG_MESSAGE_TYPE;
+    header.size = static_cast<uint32_t>(msgSize);
+    memcpy(&m_frame[framePos], &header, sizeof(SakuraGenericHeader));
+
+    if(msg.SerializeToArray(&m_frame[framePos + sizeof(SakuraGenericHeader)], msgSize) == false) {
+        m_frame.resize(framePos);
+    }
+}
+
+/**
+ * @brief send all collected entries together within one message to shiori
+ */
+void
+ErrorLogShipper::sendFrame()
+{
+    if(m_frame.size() == 0) {
+        return;
+    }
+
+    HanamiMessagingClient* client = HanamiMessaging::getInstance()->shioriClient;
+    if(client != nullptr)
+    {
+        ErrorContainer error;
+        client->sendGenericFrames(&m_frame[0], m_frame.size(), error);
+    }
+
+    m_frame.clear();
+}
+
+/**
+ * @brief collect entries of the ring-buffer and send them in batches to shiori
+ */
+void
+ErrorLogShipper::run()
+{
+    t_isShipperThread = true;
+    ErrorLogEntry entry;
+
+    while(m_abort == false)
+    {
+        uint32_t numberOfEntries = 0;
+        while(numberOfEntries < MAX_ENTRIES_PER_FRAME
+              && m_frame.size() < MAX_FRAME_SIZE
+              && getEntry(entry))
+        {
+            appendToFrame(entry);
+            numberOfEntries++;
+        }
+
+        // send counter of repeated entries of the expired deduplication-windows
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(now >= m_nextDedupCheck)
+        {
+            flushDeduplication(false);
+            m_nextDedupCheck = now + std::chrono::milliseconds(100);
+        }
+
+        sendFrame();
+
+        // report dropped entries
+        const uint64_t droppedEntries = getNumberOfDroppedEntries();
+        if(droppedEntries != m_reportedDroppedEntries)
+        {
+            LOG_WARNING("dropped "
+                        + std::to_string(droppedEntries - m_reportedDroppedEntries)
+                        + " error-messages for shiori, because the buffer was full");
+            m_reportedDroppedEntries = droppedEntries;
+        }
+
+        // wait for new entries, if the ring-buffer was drained
+        if(numberOfEntries < MAX_ENTRIES_PER_FRAME) {
+            sleepThread(10000);
+        }
+    }
+
+    flushDeduplication(true);
+    sendFrame();
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
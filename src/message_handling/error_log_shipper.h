@@ -0,0 +1,121 @@
+/**
+ * @file        error_log_shipper.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef ERROR_LOG_SHIPPER_H
+#define ERROR_LOG_SHIPPER_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <chrono>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+struct ErrorLogEntry
+{
+    std::string userId = "";
+    std::string context = "";
+    std::string values = "";
+    std::string errorMessage = "";
+};
+
+class ErrorLogShipper
+        : public Kitsunemimi::Thread
+{
+public:
+    static ErrorLogShipper* getInstance();
+
+    bool addEntry(ErrorLogEntry &entry);
+    void setDeduplicationWindow(const uint32_t windowTime);
+
+    uint64_t getNumberOfDroppedEntries() const;
+    uint64_t getNumberOfSuppressedEntries() const;
+    static bool isShipperThread();
+
+protected:
+    void run();
+
+private:
+    ErrorLogShipper();
+
+    static ErrorLogShipper* m_instance;
+
+    // bounded multi-producer single-consumer ring-buffer. Each slot has a sequence-number,
+    // which tells producer and consumer, if the slot is free or filled for the current round.
+    struct RingSlot
+    {
+        std::atomic<uint64_t> sequence{0};
+        ErrorLogEntry entry;
+    };
+
+    RingSlot* m_ring = nullptr;
+    uint64_t m_ringMask = 0;
+    std::atomic<uint64_t> m_enqueuePos{0};
+    uint64_t m_dequeuePos = 0;
+
+    std::atomic<uint64_t> m_droppedEntries{0};
+    uint64_t m_reportedDroppedEntries = 0;
+
+    // entries with the same fingerprint within the deduplication-window are only counted and
+    // send at the end of the window as one entry together with the number of occurrences
+    struct DedupEntry
+    {
+        std::chrono::steady_clock::time_point windowEnd;
+        uint64_t numberOfSuppressed = 0;
+        ErrorLogEntry duplicate;
+    };
+
+    // the deduplication-table is split by the fingerprint, so producers with different
+    // messages don't block each other
+    struct DedupShard
+    {
+        std::map<uint64_t, DedupEntry> entries;
+        std::mutex lock;
+    };
+
+    DedupShard* m_dedupShards = nullptr;
+    std::atomic<uint32_t> m_dedupWindow{1000};
+    std::atomic<uint64_t> m_suppressedEntries{0};
+    std::chrono::steady_clock::time_point m_nextDedupCheck;
+
+    std::vector<uint8_t> m_frame;
+
+    bool pushEntry(ErrorLogEntry &entry);
+    bool isDuplicate(const ErrorLogEntry &entry, DedupEntry &expiredEntry);
+    void addRepeatCounter(DedupEntry &dedupEntry);
+    void flushDeduplication(const bool flushAll);
+    bool getEntry(ErrorLogEntry &entry);
+    void appendToFrame(const ErrorLogEntry &entry);
+    void sendFrame();
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // ERROR_LOG_SHIPPER_H
@@ -0,0 +1,465 @@
+/**
+ * @file        generic_message_dispatcher.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "generic_message_dispatcher.h"
+
+#include <chrono>
+#include <vector>
+#include <string.h>
+
+#include <message_handling/messaging_event_queue.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// session, which is used by the handler within the current thread, so a handler, which closes
+// its own session, doesn't wait for itself
+thread_local SessionReference* t_activeSessionRef = nullptr;
+
+//==================================================================================================
+// GenericMessageEvent
+//==================================================================================================
+
+/**
+ * @brief constructor, which copies the message, because the buffer of the incoming message is
+ *        deleted by the network-thread after the dispatch
+ *
+ * @param handler handler to process the message
+ * @param sessionRef reference to the session, where the message belongs to
+ * @param subType sub-type of the generic message
+ * @param data pointer to the body of the message
+ * @param dataSize size of the body
+ * @param blockerId blocker-id for the response
+ */
+GenericMessageEvent::GenericMessageEvent(GenericMessageHandler handler,
+                                         SessionReference* sessionRef,
+                                         const uint32_t subType,
+                                         const void* data,
+                                         const uint64_t dataSize,
+                                         const uint64_t blockerId)
+{
+    m_handler = handler;
+    m_sessionRef = sessionRef;
+    m_subType = subType;
+    m_dataSize = dataSize;
+    m_blockerId = blockerId;
+
+    m_data = new uint8_t[dataSize];
+    memcpy(m_data, data, dataSize);
+}
+
+/**
+ * @brief destructor
+ */
+GenericMessageEvent::~GenericMessageEvent()
+{
+    GenericMessageDispatcher::getInstance()->releaseSessionReference(m_sessionRef);
+    delete[] m_data;
+}
+
+/**
+ * @brief call the handler with the copied message, if the session is still open
+ *
+ * @return false, if the session was already closed, else true
+ */
+bool
+GenericMessageEvent::processEvent()
+{
+    GenericMessageDispatcher* dispatcher = GenericMessageDispatcher::getInstance();
+
+    Sakura::Session* session = dispatcher->lockSession(m_sessionRef);
+    if(session == nullptr) {
+        return false;
+    }
+
+    m_handler(session, m_subType, m_data, m_dataSize, m_blockerId);
+    dispatcher->unlockSession(m_sessionRef);
+
+    return true;
+}
+
+//==================================================================================================
+// GenericMessageDispatcher
+//==================================================================================================
+
+Kitsunemimi::Hanami::GenericMessageDispatcher* GenericMessageDispatcher::m_instance = nullptr;
+
+/**
+ * @brief constructor
+ */
+GenericMessageDispatcher::GenericMessageDispatcher() {}
+
+/**
+ * @brief get instance of the dispatcher
+ *
+ * @return pointer to the instance of the dispatcher
+ */
+GenericMessageDispatcher*
+GenericMessageDispatcher::getInstance()
+{
+    if(m_instance == nullptr) {
+        m_instance = new GenericMessageDispatcher();
+    }
+
+    return m_instance;
+}
+
+/**
+ * @brief register a handler for a specific sub-type of generic messages
+ *
+ * @param subType sub-type, which should be processed by the handler
+ * @param handler handler to process the messages
+ * @param policy defines in which thread the handler is called
+ *
+ * @return false, if a handler for the sub-type is already registered, else true
+ */
+bool
+GenericMessageDispatcher::addHandler(const uint32_t subType,
+                                     GenericMessageHandler handler,
+                                     const GenericHandlerPolicy policy)
+{
+    std::lock_guard<std::mutex> guard(m_handlerLock);
+
+    if(handler == nullptr
+            || m_handler.find(subType) != m_handler.end())
+    {
+        return false;
+    }
+
+    HandlerEntry entry;
+    entry.handler = handler;
+    entry.policy = policy;
+
+    // each sub-type with a dedicated lane get its own thread, so the messages of this sub-type
+    // are processed in the order of their arrival without blocking other messages
+    if(policy == GENERIC_HANDLER_DEDICATED_LANE)
+    {
+        entry.lane = new GenericMessageLane("GenericMessageLane-" + std::to_string(subType));
+        entry.lane->startThread();
+    }
+
+    m_handler.emplace(subType, entry);
+
+    return true;
+}
+
+/**
+ * @brief forward an incoming generic message to the registered handler of its sub-type
+ *
+ * @param session session, where the message belongs to
+ * @param subType sub-type of the generic message
+ * @param data pointer to the body of the message
+ * @param dataSize size of the body
+ * @param blockerId blocker-id for the response
+ *
+ * @return false, if no handler is registered for the sub-type, else true
+ */
+bool
+GenericMessageDispatcher::dispatch(Sakura::Session* session,
+                                   const uint32_t subType,
+                                   void* data,
+                                   const uint64_t dataSize,
+                                   const uint64_t blockerId)
+{
+    HandlerEntry entry;
+    {
+        std::lock_guard<std::mutex> guard(m_handlerLock);
+
+        std::map<uint32_t, HandlerEntry>::const_iterator it = m_handler.find(subType);
+        if(it == m_handler.end()) {
+            return false;
+        }
+        entry = it->second;
+    }
+
+    switch(entry.policy)
+    {
+        case GENERIC_HANDLER_INLINE:
+        {
+            entry.handler(session, subType, data, dataSize, blockerId);
+            break;
+        }
+        case GENERIC_HANDLER_DISPATCH_POOL:
+        {
+            // processed and deleted by the worker-threads of the event-queue
+            GenericMessageEvent* event = new GenericMessageEvent(entry.handler,
+                                                                 addSessionReference(session),
+                                                                 subType,
+                                                                 data,
+                                                                 dataSize,
+                                                                 blockerId);
+            MessagingEventQueue::getInstance()->addEventToQueue(event);
+            break;
+        }
+        case GENERIC_HANDLER_DEDICATED_LANE:
+        {
+            GenericMessageEvent* event = new GenericMessageEvent(entry.handler,
+                                                                 addSessionReference(session),
+                                                                 subType,
+                                                                 data,
+                                                                 dataSize,
+                                                                 blockerId);
+
+            // check the lane again under the lock, because the lanes could be already stopped
+            std::lock_guard<std::mutex> guard(m_handlerLock);
+            std::map<uint32_t, HandlerEntry>::const_iterator it = m_handler.find(subType);
+            if(it->second.lane == nullptr)
+            {
+                delete event;
+                return false;
+            }
+            it->second.lane->addEvent(event);
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief mark a session as closed, so the handler of already dispatched messages are not called
+ *        anymore, and wait until all handler, which use the session at the moment, are finished.
+ *        Must be called before the session is deleted.
+ *
+ * @param session session, which is closed
+ */
+void
+GenericMessageDispatcher::removeSession(Sakura::Session* session)
+{
+    std::unique_lock<std::mutex> lock(m_sessionLock);
+
+    std::map<Sakura::Session*, SessionReference*>::iterator it = m_sessionRefs.find(session);
+    if(it == m_sessionRefs.end()) {
+        return;
+    }
+
+    // remove from the list, so a new session with the same address gets a new reference
+    SessionReference* sessionRef = it->second;
+    m_sessionRefs.erase(it);
+    sessionRef->closed = true;
+
+    const uint32_t ownHandler = (t_activeSessionRef == sessionRef) ? 1 : 0;
+    m_sessionCondition.wait(lock, [sessionRef, ownHandler] {
+        return sessionRef->numberOfActiveHandler <= ownHandler;
+    });
+
+    // the last event deletes the reference, if there are still events left
+    if(sessionRef->numberOfEvents == 0) {
+        delete sessionRef;
+    }
+}
+
+/**
+ * @brief stop the threads of all dedicated lanes and delete their remaining messages
+ */
+void
+GenericMessageDispatcher::stopLanes()
+{
+    std::vector<GenericMessageLane*> lanes;
+    {
+        std::lock_guard<std::mutex> guard(m_handlerLock);
+
+        std::map<uint32_t, HandlerEntry>::iterator it;
+        for(it = m_handler.begin(); it != m_handler.end(); it++)
+        {
+            if(it->second.lane != nullptr)
+            {
+                lanes.push_back(it->second.lane);
+                it->second.lane = nullptr;
+            }
+        }
+    }
+
+    for(GenericMessageLane* lane : lanes)
+    {
+        lane->close();
+        delete lane;
+    }
+}
+
+/**
+ * @brief get reference of a session for a new deferred event
+ *
+ * @param session session, where the event belongs to
+ *
+ * @return reference of the session
+ */
+SessionReference*
+GenericMessageDispatcher::addSessionReference(Sakura::Session* session)
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    SessionReference* sessionRef = nullptr;
+    std::map<Sakura::Session*, SessionReference*>::const_iterator it = m_sessionRefs.find(session);
+    if(it != m_sessionRefs.end())
+    {
+        sessionRef = it->second;
+    }
+    else
+    {
+        sessionRef = new SessionReference();
+        sessionRef->session = session;
+        m_sessionRefs.insert(std::make_pair(session, sessionRef));
+    }
+
+    sessionRef->numberOfEvents++;
+
+    return sessionRef;
+}
+
+/**
+ * @brief give back the reference of a deleted event
+ *
+ * @param sessionRef reference of the session
+ */
+void
+GenericMessageDispatcher::releaseSessionReference(SessionReference* sessionRef)
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    sessionRef->numberOfEvents--;
+    if(sessionRef->numberOfEvents > 0) {
+        return;
+    }
+
+    // references of open sessions are kept, so not each message allocates a new one
+    if(sessionRef->closed) {
+        delete sessionRef;
+    }
+}
+
+/**
+ * @brief get the session of a reference for calling a handler, which prevents the session
+ *        from being deleted until unlockSession is called
+ *
+ * @param sessionRef reference of the session
+ *
+ * @return nullptr, if the session was already closed, else pointer to the session
+ */
+Sakura::Session*
+GenericMessageDispatcher::lockSession(SessionReference* sessionRef)
+{
+    std::lock_guard<std::mutex> guard(m_sessionLock);
+
+    if(sessionRef->closed) {
+        return nullptr;
+    }
+
+    sessionRef->numberOfActiveHandler++;
+    t_activeSessionRef = sessionRef;
+
+    return sessionRef->session;
+}
+
+/**
+ * @brief release the session after the handler was called
+ *
+ * @param sessionRef reference of the session
+ */
+void
+GenericMessageDispatcher::unlockSession(SessionReference* sessionRef)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_sessionLock);
+        sessionRef->numberOfActiveHandler--;
+        t_activeSessionRef = nullptr;
+    }
+
+    m_sessionCondition.notify_all();
+}
+
+//==================================================================================================
+// GenericMessageLane
+//==================================================================================================
+
+/**
+ * @brief constructor
+ *
+ * @param threadName name of the thread of the lane
+ */
+GenericMessageLane::GenericMessageLane(const std::string &threadName)
+    : Kitsunemimi::Thread(threadName) {}
+
+/**
+ * @brief add new event to the lane and wake up the thread of the lane
+ *
+ * @param event new event to add
+ */
+void
+GenericMessageLane::addEvent(GenericMessageEvent* event)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        m_queue.push_back(event);
+    }
+
+    m_queueCondition.notify_one();
+}
+
+/**
+ * @brief stop the thread of the lane and delete all messages, which were not processed
+ */
+void
+GenericMessageLane::close()
+{
+    stopThread();
+
+    std::lock_guard<std::mutex> guard(m_queueLock);
+    for(GenericMessageEvent* event : m_queue) {
+        delete event;
+    }
+    m_queue.clear();
+}
+
+/**
+ * @brief process the events of the lane one after another
+ */
+void
+GenericMessageLane::run()
+{
+    while(m_abort == false)
+    {
+        GenericMessageEvent* event = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_queueLock);
+
+            // wait up to 10ms, to check the abort-flag from time to time
+            if(m_queue.size() == 0) {
+                m_queueCondition.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            if(m_queue.size() == 0) {
+                continue;
+            }
+
+            event = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        event->processEvent();
+        delete event;
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,149 @@
+/**
+ * @file        generic_message_dispatcher.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef GENERIC_MESSAGE_DISPATCHER_H
+#define GENERIC_MESSAGE_DISPATCHER_H
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+#include <libKitsunemimiCommon/threading/event.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura {
+class Session;
+}
+namespace Hanami
+{
+class GenericMessageLane;
+class GenericMessageDispatcher;
+
+typedef void (*GenericMessageHandler)(Sakura::Session*,
+                                      const uint32_t,
+                                      void*,
+                                      const uint64_t,
+                                      const uint64_t);
+
+// reference of deferred events to their session, because the session can be closed and deleted,
+// before the handler is called
+struct SessionReference
+{
+    Sakura::Session* session = nullptr;
+    uint32_t numberOfEvents = 0;
+    uint32_t numberOfActiveHandler = 0;
+    bool closed = false;
+};
+
+class GenericMessageEvent
+        : public Event
+{
+public:
+    GenericMessageEvent(GenericMessageHandler handler,
+                        SessionReference* sessionRef,
+                        const uint32_t subType,
+                        const void* data,
+                        const uint64_t dataSize,
+                        const uint64_t blockerId);
+    ~GenericMessageEvent();
+
+    bool processEvent();
+
+private:
+    GenericMessageHandler m_handler = nullptr;
+    SessionReference* m_sessionRef = nullptr;
+    uint32_t m_subType = 0;
+    uint8_t* m_data = nullptr;
+    uint64_t m_dataSize = 0;
+    uint64_t m_blockerId = 0;
+};
+
+class GenericMessageDispatcher
+{
+public:
+    static GenericMessageDispatcher* getInstance();
+
+    bool addHandler(const uint32_t subType,
+                    GenericMessageHandler handler,
+                    const GenericHandlerPolicy policy);
+    bool dispatch(Sakura::Session* session,
+                  const uint32_t subType,
+                  void* data,
+                  const uint64_t dataSize,
+                  const uint64_t blockerId);
+    void removeSession(Sakura::Session* session);
+    void stopLanes();
+
+private:
+    GenericMessageDispatcher();
+
+    friend GenericMessageEvent;
+
+    static GenericMessageDispatcher* m_instance;
+
+    struct HandlerEntry
+    {
+        GenericMessageHandler handler = nullptr;
+        GenericHandlerPolicy policy = GENERIC_HANDLER_INLINE;
+        GenericMessageLane* lane = nullptr;
+    };
+
+    std::map<uint32_t, HandlerEntry> m_handler;
+    std::mutex m_handlerLock;
+
+    std::map<Sakura::Session*, SessionReference*> m_sessionRefs;
+    std::mutex m_sessionLock;
+    std::condition_variable m_sessionCondition;
+
+    SessionReference* addSessionReference(Sakura::Session* session);
+    void releaseSessionReference(SessionReference* sessionRef);
+    Sakura::Session* lockSession(SessionReference* sessionRef);
+    void unlockSession(SessionReference* sessionRef);
+};
+
+class GenericMessageLane
+        : public Kitsunemimi::Thread
+{
+public:
+    GenericMessageLane(const std::string &threadName);
+
+    void addEvent(GenericMessageEvent* event);
+    void close();
+
+protected:
+    void run();
+
+private:
+    std::deque<GenericMessageEvent*> m_queue;
+    std::mutex m_queueLock;
+    std::condition_variable m_queueCondition;
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // GENERIC_MESSAGE_DISPATCHER_H
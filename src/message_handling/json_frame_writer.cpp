@@ -0,0 +1,347 @@
+/**
+ * @file        json_frame_writer.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "json_frame_writer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <cmath>
+
+#include <message_handling/request_arena.h>
+#include <message_handling/message_definitions.h>
+
+#include <libKitsunemimiCommon/items/data_items.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ *
+ * @param arena arena, which provides the memory for the frame
+ * @param headerSize number of bytes to reserve at the beginning of the frame for the header
+ * @param initialSize initial number of bytes to reserve for the json-content
+ */
+JsonFrameWriter::JsonFrameWriter(RequestArena &arena,
+                                 const uint64_t headerSize,
+                                 const uint64_t initialSize)
+{
+    m_arena = &arena;
+    m_headerSize = headerSize;
+    m_capacity = headerSize + initialSize;
+    m_buffer = static_cast<uint8_t*>(m_arena->allocate(m_capacity));
+    m_size = headerSize;
+}
+
+/**
+ * @brief get the complete frame
+ *
+ * @return pointer to the beginning of the frame, which starts with the reserved header-slot
+ */
+uint8_t*
+JsonFrameWriter::getFrame()
+{
+    return m_buffer;
+}
+
+/**
+ * @brief get size of the complete frame
+ *
+ * @return size of header-slot and json-content in bytes
+ */
+uint64_t
+JsonFrameWriter::getFrameSize() const
+{
+    return m_size;
+}
+
+/**
+ * @brief get size of the written json-content
+ *
+ * @return size of the json-content in bytes
+ */
+uint64_t
+JsonFrameWriter::getContentSize() const
+{
+    return m_size - m_headerSize;
+}
+
+/**
+ * @brief fill the reserved header-slot with a response-header, which contains the size of the
+ *        written json-content. Requires, that the writer was created with the size of the
+ *        response-header as header-size.
+ *
+ * @param success success-result of the response
+ * @param responseType response http-type
+ *
+ * @return pointer to the beginning of the complete frame
+ */
+uint8_t*
+JsonFrameWriter::finishResponseFrame(const bool success,
+                                     const HttpResponseTypes responseType)
+{
+    ResponseHeader responseHeader;
+    responseHeader.success = success;
+    responseHeader.responseType = responseType;
+    responseHeader.messageSize = static_cast<uint32_t>(getContentSize());
+    memcpy(m_buffer, &responseHeader, sizeof(ResponseHeader));
+
+    return m_buffer;
+}
+
+/**
+ * @brief make sure, that the buffer has enough free space, and grow the buffer if necessary
+ *
+ * @param additionalSize number of bytes, which should be appended
+ */
+void
+JsonFrameWriter::reserve(const uint64_t additionalSize)
+{
+    if(m_size + additionalSize <= m_capacity) {
+        return;
+    }
+
+    uint64_t newCapacity = m_capacity * 2;
+    while(newCapacity < m_size + additionalSize) {
+        newCapacity *= 2;
+    }
+
+    m_buffer = static_cast<uint8_t*>(m_arena->grow(m_buffer, m_capacity, newCapacity));
+    m_capacity = newCapacity;
+}
+
+/**
+ * @brief append data to the frame
+ *
+ * @param data pointer to the data to append
+ * @param dataSize number of bytes to append
+ */
+void
+JsonFrameWriter::append(const char* data,
+                        const uint64_t dataSize)
+{
+    reserve(dataSize);
+    memcpy(&m_buffer[m_size], data, dataSize);
+    m_size += dataSize;
+}
+
+/**
+ * @brief append a single character to the frame
+ *
+ * @param character character to append
+ */
+void
+JsonFrameWriter::append(const char character)
+{
+    reserve(1);
+    m_buffer[m_size] = static_cast<uint8_t>(character);
+    m_size++;
+}
+
+/**
+ * @brief write a string with quotes and escaped special characters
+ *
+ * @param value string to write
+ */
+void
+JsonFrameWriter::writeString(const std::string &value)
+{
+    append('\"');
+
+    const char* data = value.c_str();
+    uint64_t start = 0;
+    for(uint64_t i = 0; i < value.size(); i++)
+    {
+        const unsigned char character = static_cast<unsigned char>(data[i]);
+        if(character >= 0x20
+                && character != '\"'
+                && character != '\\')
+        {
+            continue;
+        }
+
+        // write unescaped part up to the special character
+        append(&data[start], i - start);
+        start = i + 1;
+
+        switch(character)
+        {
+            case '\"': append("\\\"", 2); break;
+            case '\\': append("\\\\", 2); break;
+            case '\n': append("\\n", 2); break;
+            case '\r': append("\\r", 2); break;
+            case '\t': append("\\t", 2); break;
+            case '\b': append("\\b", 2); break;
+            case '\f': append("\\f", 2); break;
+            default:
+            {
+                char escaped[8];
+                const int escapedSize = snprintf(escaped, sizeof(escaped), "\\u%04x", character);
+                append(escaped, static_cast<uint64_t>(escapedSize));
+                break;
+            }
+        }
+    }
+    append(&data[start], value.size() - start);
+
+    append('\"');
+}
+
+/**
+ * @brief convert a finite double into the shortest string, which is parsed back into exactly
+ *        the same value
+ *
+ * @param buffer target-buffer
+ * @param bufferSize size of the target-buffer
+ * @param value value to convert
+ *
+ * @return number of written characters
+ */
+static int
+writeDouble(char* buffer,
+            const uint64_t bufferSize,
+            const double value)
+{
+    int size = 0;
+    for(int precision = 15; precision <= 17; precision++)
+    {
+        size = snprintf(buffer, bufferSize, "%.*g", precision, value);
+        if(strtod(buffer, nullptr) == value) {
+            break;
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief write a single value
+ *
+ * @param item value-item to write
+ */
+void
+JsonFrameWriter::writeValue(DataItem* item)
+{
+    DataValue* value = item->toValue();
+    char number[32];
+    int numberSize = 0;
+
+    switch(value->getValueType())
+    {
+        case DataItem::STRING_TYPE:
+            writeString(value->getString());
+            break;
+        case DataItem::INT_TYPE:
+            numberSize = snprintf(number, sizeof(number), "%ld", value->getLong());
+            append(number, static_cast<uint64_t>(numberSize));
+            break;
+        case DataItem::FLOAT_TYPE:
+            // json has no representation for nan and infinity
+            if(std::isfinite(value->getDouble()) == false)
+            {
+                append("null", 4);
+                break;
+            }
+            numberSize = writeDouble(number, sizeof(number), value->getDouble());
+            append(number, static_cast<uint64_t>(numberSize));
+            // make sure, that the value is still identified as float by the receiver
+            if(strpbrk(number, ".eE") == nullptr) {
+                append(".0", 2);
+            }
+            break;
+        case DataItem::BOOL_TYPE:
+            if(value->getBool()) {
+                append("true", 4);
+            } else {
+                append("false", 5);
+            }
+            break;
+        default:
+            append("null", 4);
+            break;
+    }
+}
+
+/**
+ * @brief write a data-item with all of its childs as compact json into the frame
+ *
+ * @param item item to write
+ */
+void
+JsonFrameWriter::writeItem(DataItem* item)
+{
+    if(item == nullptr)
+    {
+        append("null", 4);
+        return;
+    }
+
+    if(item->getType() == DataItem::MAP_TYPE)
+    {
+        DataMap* map = item->toMap();
+
+        append('{');
+        bool first = true;
+        std::map<std::string, DataItem*>::const_iterator it;
+        for(it = map->map.begin();
+            it != map->map.end();
+            it++)
+        {
+            if(first == false) {
+                append(',');
+            }
+            first = false;
+
+            writeString(it->first);
+            append(':');
+            writeItem(it->second);
+        }
+        append('}');
+
+        return;
+    }
+
+    if(item->getType() == DataItem::ARRAY_TYPE)
+    {
+        DataArray* array = item->toArray();
+
+        append('[');
+        for(uint64_t i = 0; i < array->array.size(); i++)
+        {
+            if(i != 0) {
+                append(',');
+            }
+            writeItem(array->array[i]);
+        }
+        append(']');
+
+        return;
+    }
+
+    writeValue(item);
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
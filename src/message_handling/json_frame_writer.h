@@ -0,0 +1,70 @@
+/**
+ * @file        json_frame_writer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef JSON_FRAME_WRITER_H
+#define JSON_FRAME_WRITER_H
+
+#include <string>
+#include <stdint.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+namespace Kitsunemimi
+{
+class DataItem;
+
+namespace Hanami
+{
+class RequestArena;
+
+class JsonFrameWriter
+{
+public:
+    JsonFrameWriter(RequestArena &arena,
+                    const uint64_t headerSize,
+                    const uint64_t initialSize = 4096);
+
+    void writeItem(DataItem* item);
+
+    uint8_t* getFrame();
+    uint64_t getFrameSize() const;
+    uint64_t getContentSize() const;
+    uint8_t* finishResponseFrame(const bool success, const HttpResponseTypes responseType);
+
+private:
+    RequestArena* m_arena = nullptr;
+    uint8_t* m_buffer = nullptr;
+    uint64_t m_headerSize = 0;
+    uint64_t m_size = 0;
+    uint64_t m_capacity = 0;
+
+    void reserve(const uint64_t additionalSize);
+    void append(const char* data, const uint64_t dataSize);
+    void append(const char character);
+    void writeString(const std::string &value);
+    void writeValue(DataItem* item);
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // JSON_FRAME_WRITER_H
@@ -0,0 +1,903 @@
+/**
+ * @file        json_input_parser.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "json_input_parser.h"
+#include "json_scanner.h"
+
+#include <items/item_methods.h>
+
+#include <libKitsunemimiHanamiNetwork/blossom.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiJson/json_item.h>
+
+#include <runtime_validation.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// limit for nested maps and arrays to protect the stack against malicious input
+const uint32_t MAX_NESTING_DEPTH = 512;
+
+/**
+ * @brief parse json-formated input with the parser, which is selected by the config
+ *
+ * @param result reference for the resulting map
+ * @param input pointer to the json-string
+ * @param inputSize size of the json-string
+ * @param blossom blossom to validate the input-fields against, or nullptr to skip validation.
+ *                Only used by the JsonInputParser, else the validation is done later by the
+ *                blossom itself.
+ * @param errorMessage reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+parseJsonInput(DataMap &result,
+               const char* input,
+               const uint64_t inputSize,
+               const Blossom* blossom,
+               std::string &errorMessage)
+{
+    if(HanamiMessaging::getInstance()->useFastJsonParser)
+    {
+        JsonInputParser parser;
+        return parser.parse(result, input, inputSize, blossom, errorMessage);
+    }
+
+    // fallback to the generic parser
+    ErrorContainer error;
+    JsonItem parsedItem;
+    if(parsedItem.parse(std::string(input, inputSize), error) == false)
+    {
+        errorMessage = error.toString();
+        return false;
+    }
+
+    DataItem* content = parsedItem.getItemContent();
+    if(content == nullptr
+            || content->isMap() == false)
+    {
+        errorMessage = "Failed to parse input-values, because they are not a json-map";
+        return false;
+    }
+
+    result.clear();
+    moveItems(result, *content->toMap(), ALL);
+
+    return true;
+}
+
+/**
+ * @brief constructor
+ */
+JsonInputParser::JsonInputParser() {}
+
+/**
+ * @brief parse the json-formated input-values of a request. If a blossom is given, the top-level
+ *        fields are validated against its input-fields while parsing, so invalid input is
+ *        rejected at the first offending field without building the rest of the tree.
+ *
+ * @param result reference for the resulting map
+ * @param input pointer to the json-string
+ * @param inputSize size of the json-string
+ * @param blossom blossom to validate the input-fields against, or nullptr to skip validation
+ * @param errorMessage reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parse(DataMap &result,
+                       const char* input,
+                       const uint64_t inputSize,
+                       const Blossom* blossom,
+                       std::string &errorMessage)
+{
+    m_input = input;
+    m_inputSize = inputSize;
+    m_pos = 0;
+    m_depth = 0;
+    m_errorMessage = &errorMessage;
+
+    const std::map<std::string, FieldDef>* schema = nullptr;
+    bool allowUnmatched = true;
+    if(blossom != nullptr)
+    {
+        schema = blossom->getInputValidationMap();
+        allowUnmatched = blossom->allowUnmatched;
+    }
+
+    // parse top-level map
+    skipWhitespace();
+    if(parseInputMap(result, schema, allowUnmatched) == false) {
+        return false;
+    }
+
+    // make sure, that there is nothing behind the map
+    skipWhitespace();
+    if(m_pos != m_inputSize) {
+        return setSyntaxError("unexpected content after the end of the input");
+    }
+
+    return checkRequiredFields(result, schema);
+}
+
+/**
+ * @brief parse top-level map of the input and validate each field, before its value is parsed
+ *
+ * @param result reference for the resulting map
+ * @param schema input-fields of the blossom, or nullptr to skip validation
+ * @param allowUnmatched true to accept fields, which are not registered in the schema
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseInputMap(DataMap &result,
+                               const std::map<std::string, FieldDef>* schema,
+                               const bool allowUnmatched)
+{
+    if(consume('{') == false) {
+        return setSyntaxError("expected '{' at the begin of the input");
+    }
+
+    skipWhitespace();
+    if(consume('}')) {
+        return true;
+    }
+
+    std::string key;
+    while(true)
+    {
+        // get key
+        skipWhitespace();
+        if(parseString(key) == false) {
+            return false;
+        }
+        skipWhitespace();
+        if(consume(':') == false) {
+            return setSyntaxError("expected ':' behind key '" + key + "'");
+        }
+        skipWhitespace();
+
+        // check field before parsing its value
+        // the token is not part of the blossom-input, but is removed again before the trigger
+        const FieldDef* fieldDef = nullptr;
+        if(schema != nullptr
+                && key != "token")
+        {
+            // like validateFieldsCompleteness, each key of the schema is allowed, but only the
+            // input-fields are checked, like in checkBlossomValues
+            std::map<std::string, FieldDef>::const_iterator defIt;
+            defIt = schema->find(key);
+            if(defIt != schema->end())
+            {
+                if(defIt->second.ioType == FieldDef::INPUT_TYPE)
+                {
+                    fieldDef = &defIt->second;
+                    if(checkFieldType(key, *fieldDef) == false) {
+                        return false;
+                    }
+                }
+            }
+            else if(allowUnmatched == false)
+            {
+                *m_errorMessage = "Validation failed, because item '"
+                                  + key
+                                  + "' is not in the list of allowed keys";
+                return false;
+            }
+        }
+
+        // get value
+        DataItem* value = nullptr;
+        const bool ret = parseValue(value);
+        if(value != nullptr) {
+            result.insert(key, value, true);
+        }
+        if(ret == false) {
+            return false;
+        }
+
+        if(fieldDef != nullptr
+                && checkFieldBorder(key, *fieldDef, value) == false)
+        {
+            return false;
+        }
+
+        // check for next field
+        skipWhitespace();
+        if(consume('}')) {
+            return true;
+        }
+        if(consume(',') == false) {
+            return setSyntaxError("expected ',' or '}' within map");
+        }
+    }
+}
+
+/**
+ * @brief check type of the next value against the type of the field without parsing the value
+ *
+ * @param name name of the field
+ * @param fieldDef definition of the field
+ *
+ * @return true, if type match, else false
+ */
+bool
+JsonInputParser::checkFieldType(const std::string &name,
+                                const FieldDef &fieldDef)
+{
+    FieldType type = SAKURA_UNDEFINED_TYPE;
+
+    if(m_pos < m_inputSize)
+    {
+        const char character = m_input[m_pos];
+        if(character == '"') {
+            type = SAKURA_STRING_TYPE;
+        } else if(character == '{') {
+            type = SAKURA_MAP_TYPE;
+        } else if(character == '[') {
+            type = SAKURA_ARRAY_TYPE;
+        } else if(character == 't' || character == 'f') {
+            type = SAKURA_BOOL_TYPE;
+        }
+        else if(character == '-' || (character >= '0' && character <= '9'))
+        {
+            // a fraction or exponent makes the number to a float-value
+            type = SAKURA_INT_TYPE;
+            for(uint64_t i = m_pos; i < m_inputSize; i++)
+            {
+                const char numChar = m_input[i];
+                if(numChar == '.' || numChar == 'e' || numChar == 'E') {
+                    type = SAKURA_FLOAT_TYPE;
+                } else if(numChar != '-' && numChar != '+' && (numChar < '0' || numChar > '9')) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if(type != fieldDef.fieldType)
+    {
+        *m_errorMessage = createErrorMessage(name, fieldDef.fieldType);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief check value-border of int-values and length-border of string-values
+ *
+ * @param name name of the field
+ * @param fieldDef definition of the field
+ * @param item parsed value of the field
+ *
+ * @return true, if value is within the borders or no borders are defined, else false
+ */
+bool
+JsonInputParser::checkFieldBorder(const std::string &name,
+                                  const FieldDef &fieldDef,
+                                  DataItem* item)
+{
+    if(fieldDef.upperBorder == 0
+            && fieldDef.lowerBorder == 0)
+    {
+        return true;
+    }
+
+    if(item->isIntValue())
+    {
+        const long value = item->toValue()->getLong();
+        if(value < fieldDef.lowerBorder)
+        {
+            *m_errorMessage = "Given item '"
+                              + name
+                              + "' is smaller than "
+                              + std::to_string(fieldDef.lowerBorder);
+            return false;
+        }
+
+        if(value > fieldDef.upperBorder)
+        {
+            *m_errorMessage = "Given item '"
+                              + name
+                              + "' is bigger than "
+                              + std::to_string(fieldDef.upperBorder);
+            return false;
+        }
+    }
+
+    if(item->isStringValue())
+    {
+        const long length = item->toValue()->getString().size();
+        if(length < fieldDef.lowerBorder)
+        {
+            *m_errorMessage = "Given item '"
+                              + name
+                              + "' is shorter than "
+                              + std::to_string(fieldDef.lowerBorder)
+                              + " characters";
+            return false;
+        }
+
+        if(length > fieldDef.upperBorder)
+        {
+            *m_errorMessage = "Given item '"
+                              + name
+                              + "' is longer than "
+                              + std::to_string(fieldDef.upperBorder)
+                              + " characters";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief check that all required input-fields were set. Fields with a default-value are never
+ *        required, so they are filled later by the blossom itself.
+ *
+ * @param result parsed input-values
+ * @param schema input-fields of the blossom, or nullptr to skip validation
+ *
+ * @return true, if all required fields are set, else false
+ */
+bool
+JsonInputParser::checkRequiredFields(const DataMap &result,
+                                     const std::map<std::string, FieldDef>* schema)
+{
+    if(schema == nullptr) {
+        return true;
+    }
+
+    std::map<std::string, FieldDef>::const_iterator defIt;
+    for(defIt = schema->begin();
+        defIt != schema->end();
+        defIt++)
+    {
+        if(defIt->second.isRequired
+                && defIt->second.ioType == FieldDef::INPUT_TYPE
+                && result.contains(defIt->first) == false)
+        {
+            *m_errorMessage = "Validation failed, because variable '"
+                              + defIt->first
+                              + "' is required, but is not set.";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief parse a single value at the current position
+ *
+ * @param result reference for the new item
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseValue(DataItem* &result)
+{
+    if(m_pos >= m_inputSize) {
+        return setSyntaxError("unexpected end of the input");
+    }
+
+    const char character = m_input[m_pos];
+
+    if(character == '"')
+    {
+        std::string value;
+        if(parseString(value) == false) {
+            return false;
+        }
+        result = new DataValue(value);
+        return true;
+    }
+
+    if(character == '{' || character == '[')
+    {
+        if(m_depth >= MAX_NESTING_DEPTH) {
+            return setSyntaxError("input is nested too deep");
+        }
+        m_depth++;
+
+        bool ret = false;
+        if(character == '{')
+        {
+            DataMap* map = new DataMap();
+            result = map;
+            ret = parseMap(map);
+        }
+        else
+        {
+            DataArray* array = new DataArray();
+            result = array;
+            ret = parseArray(array);
+        }
+
+        m_depth--;
+        return ret;
+    }
+
+    if(character == '-' || (character >= '0' && character <= '9')) {
+        return parseNumber(result);
+    }
+
+    return parseLiteral(result);
+}
+
+/**
+ * @brief parse a nested map
+ *
+ * @param result pointer to the map to fill
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseMap(DataMap* result)
+{
+    m_pos++;
+    skipWhitespace();
+    if(consume('}')) {
+        return true;
+    }
+
+    std::string key;
+    while(true)
+    {
+        skipWhitespace();
+        if(parseString(key) == false) {
+            return false;
+        }
+        skipWhitespace();
+        if(consume(':') == false) {
+            return setSyntaxError("expected ':' behind key '" + key + "'");
+        }
+        skipWhitespace();
+
+        // value is also added in case of an error to be deleted together with the map
+        DataItem* value = nullptr;
+        const bool ret = parseValue(value);
+        if(value != nullptr) {
+            result->insert(key, value, true);
+        }
+        if(ret == false) {
+            return false;
+        }
+
+        skipWhitespace();
+        if(consume('}')) {
+            return true;
+        }
+        if(consume(',') == false) {
+            return setSyntaxError("expected ',' or '}' within map");
+        }
+    }
+}
+
+/**
+ * @brief parse a nested array
+ *
+ * @param result pointer to the array to fill
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseArray(DataArray* result)
+{
+    m_pos++;
+    skipWhitespace();
+    if(consume(']')) {
+        return true;
+    }
+
+    while(true)
+    {
+        skipWhitespace();
+
+        DataItem* value = nullptr;
+        const bool ret = parseValue(value);
+        if(value != nullptr) {
+            result->append(value);
+        }
+        if(ret == false) {
+            return false;
+        }
+
+        skipWhitespace();
+        if(consume(']')) {
+            return true;
+        }
+        if(consume(',') == false) {
+            return setSyntaxError("expected ',' or ']' within array");
+        }
+    }
+}
+
+/**
+ * @brief parse a string at the current position and resolve all escape-sequences
+ *
+ * @param result reference for the resulting string
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseString(std::string &result)
+{
+    if(consume('"') == false) {
+        return setSyntaxError("expected string");
+    }
+
+    result.clear();
+    while(m_pos < m_inputSize)
+    {
+        // copy all characters until the next special character at once
+        const uint64_t start = m_pos;
+        m_pos = findStringSpecial(m_input, m_pos, m_inputSize);
+        result.append(&m_input[start], m_pos - start);
+
+        if(m_pos >= m_inputSize) {
+            break;
+        }
+
+        const char character = m_input[m_pos];
+        if(character == '"')
+        {
+            m_pos++;
+            return true;
+        }
+        if(character != '\\') {
+            return setSyntaxError("control-character within string");
+        }
+
+        // handle escape-sequence
+        m_pos++;
+        if(m_pos >= m_inputSize) {
+            break;
+        }
+        const char escaped = m_input[m_pos];
+        m_pos++;
+        switch(escaped)
+        {
+            case '"':  result.push_back('"');  break;
+            case '\\': result.push_back('\\'); break;
+            case '/':  result.push_back('/');  break;
+            case 'b':  result.push_back('\b'); break;
+            case 'f':  result.push_back('\f'); break;
+            case 'n':  result.push_back('\n'); break;
+            case 'r':  result.push_back('\r'); break;
+            case 't':  result.push_back('\t'); break;
+            case 'u':
+                if(parseUnicodeEscape(result) == false) {
+                    return false;
+                }
+                break;
+            default:
+                m_pos--;
+                return setSyntaxError("invalid escape-sequence within string");
+        }
+    }
+
+    return setSyntaxError("unterminated string");
+}
+
+/**
+ * @brief convert an unicode-escape-sequence into utf-8
+ *
+ * @param result reference for the string to extend
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseUnicodeEscape(std::string &result)
+{
+    uint32_t codePoint = 0;
+    if(parseHex(codePoint) == false) {
+        return false;
+    }
+
+    // combine surrogate-pair
+    if(codePoint >= 0xD800 && codePoint <= 0xDBFF)
+    {
+        uint32_t low = 0;
+        if(m_pos + 1 >= m_inputSize
+                || m_input[m_pos] != '\\'
+                || m_input[m_pos + 1] != 'u')
+        {
+            return setSyntaxError("incomplete surrogate-pair");
+        }
+        m_pos += 2;
+        if(parseHex(low) == false) {
+            return false;
+        }
+        if(low < 0xDC00 || low > 0xDFFF) {
+            return setSyntaxError("invalid surrogate-pair");
+        }
+        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+    }
+
+    if(codePoint < 0x80)
+    {
+        result.push_back(static_cast<char>(codePoint));
+    }
+    else if(codePoint < 0x800)
+    {
+        result.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else if(codePoint < 0x10000)
+    {
+        result.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+    else
+    {
+        result.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        result.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        result.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+
+    return true;
+}
+
+/**
+ * @brief parse the four hex-digits of an unicode-escape-sequence
+ *
+ * @param result reference for the resulting value
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseHex(uint32_t &result)
+{
+    if(m_pos + 4 > m_inputSize) {
+        return setSyntaxError("incomplete unicode-escape-sequence");
+    }
+
+    result = 0;
+    for(uint32_t i = 0; i < 4; i++)
+    {
+        const char character = m_input[m_pos];
+        result <<= 4;
+        if(character >= '0' && character <= '9') {
+            result |= static_cast<uint32_t>(character - '0');
+        } else if(character >= 'a' && character <= 'f') {
+            result |= static_cast<uint32_t>(character - 'a' + 10);
+        } else if(character >= 'A' && character <= 'F') {
+            result |= static_cast<uint32_t>(character - 'A' + 10);
+        } else {
+            return setSyntaxError("invalid unicode-escape-sequence");
+        }
+        m_pos++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief parse an int- or float-value at the current position
+ *
+ * @param result reference for the new item
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseNumber(DataItem* &result)
+{
+    const uint64_t start = m_pos;
+    bool isFloat = false;
+    bool isNegative = false;
+    uint64_t intValue = 0;
+    uint32_t numberOfDigits = 0;
+
+    // validate number-syntax and convert the integer-part on the fly
+    if(m_pos < m_inputSize && m_input[m_pos] == '-')
+    {
+        isNegative = true;
+        m_pos++;
+    }
+    if(m_pos >= m_inputSize || m_input[m_pos] < '0' || m_input[m_pos] > '9') {
+        return setSyntaxError("invalid number");
+    }
+    if(m_input[m_pos] == '0')
+    {
+        numberOfDigits = 1;
+        m_pos++;
+    }
+    else
+    {
+        while(m_pos < m_inputSize && m_input[m_pos] >= '0' && m_input[m_pos] <= '9')
+        {
+            intValue = intValue * 10 + static_cast<uint64_t>(m_input[m_pos] - '0');
+            numberOfDigits++;
+            m_pos++;
+        }
+    }
+
+    if(m_pos < m_inputSize && m_input[m_pos] == '.')
+    {
+        isFloat = true;
+        m_pos++;
+        if(m_pos >= m_inputSize || m_input[m_pos] < '0' || m_input[m_pos] > '9') {
+            return setSyntaxError("invalid fraction of number");
+        }
+        while(m_pos < m_inputSize && m_input[m_pos] >= '0' && m_input[m_pos] <= '9') {
+            m_pos++;
+        }
+    }
+
+    if(m_pos < m_inputSize && (m_input[m_pos] == 'e' || m_input[m_pos] == 'E'))
+    {
+        isFloat = true;
+        m_pos++;
+        if(m_pos < m_inputSize && (m_input[m_pos] == '+' || m_input[m_pos] == '-')) {
+            m_pos++;
+        }
+        if(m_pos >= m_inputSize || m_input[m_pos] < '0' || m_input[m_pos] > '9') {
+            return setSyntaxError("invalid exponent of number");
+        }
+        while(m_pos < m_inputSize && m_input[m_pos] >= '0' && m_input[m_pos] <= '9') {
+            m_pos++;
+        }
+    }
+
+    // up to 18 digits always fit into a long, so no further conversion is necessary
+    if(isFloat == false
+            && numberOfDigits <= 18)
+    {
+        const long value = static_cast<long>(intValue);
+        result = new DataValue(isNegative ? -value : value);
+        return true;
+    }
+
+    // the input is not null-terminated, so the number has to be copied for the conversion
+    const uint64_t length = m_pos - start;
+    char buffer[64];
+    if(length >= sizeof(buffer)) {
+        return setSyntaxError("number is too long");
+    }
+    memcpy(buffer, &m_input[start], length);
+    buffer[length] = '\0';
+
+    if(isFloat == false)
+    {
+        errno = 0;
+        const long value = strtol(buffer, nullptr, 10);
+        if(errno != ERANGE)
+        {
+            result = new DataValue(value);
+            return true;
+        }
+    }
+
+    result = new DataValue(strtod(buffer, nullptr));
+    return true;
+}
+
+/**
+ * @brief parse the literals true, false and null
+ *
+ * @param result reference for the new item
+ *
+ * @return true, if successful, else false
+ */
+bool
+JsonInputParser::parseLiteral(DataItem* &result)
+{
+    const uint64_t remaining = m_inputSize - m_pos;
+    const char* start = &m_input[m_pos];
+
+    if(remaining >= 4 && memcmp(start, "true", 4) == 0)
+    {
+        m_pos += 4;
+        result = new DataValue(true);
+        return true;
+    }
+
+    if(remaining >= 5 && memcmp(start, "false", 5) == 0)
+    {
+        m_pos += 5;
+        result = new DataValue(false);
+        return true;
+    }
+
+    if(remaining >= 4 && memcmp(start, "null", 4) == 0)
+    {
+        m_pos += 4;
+        result = new DataValue();
+        return true;
+    }
+
+    return setSyntaxError("unexpected character");
+}
+
+/**
+ * @brief move the position behind all whitespaces
+ */
+void
+JsonInputParser::skipWhitespace()
+{
+    // most tokens are not preceded by whitespaces, so check the first byte before scanning
+    if(m_pos < m_inputSize)
+    {
+        const char character = m_input[m_pos];
+        if(character != ' '
+                && character != '\n'
+                && character != '\r'
+                && character != '\t')
+        {
+            return;
+        }
+        m_pos = findNonWhitespace(m_input, m_pos + 1, m_inputSize);
+    }
+}
+
+/**
+ * @brief consume the next character, if it matches the expected one
+ *
+ * @param character expected character
+ *
+ * @return true, if matched and consumed, else false
+ */
+bool
+JsonInputParser::consume(const char character)
+{
+    if(m_pos < m_inputSize
+            && m_input[m_pos] == character)
+    {
+        m_pos++;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief write syntax-error together with the position of the offending byte
+ *
+ * @param reason reason of the error
+ *
+ * @return always false
+ */
+bool
+JsonInputParser::setSyntaxError(const std::string &reason)
+{
+    *m_errorMessage = "Failed to parse input-values at position "
+                      + std::to_string(m_pos)
+                      + ": "
+                      + reason;
+    return false;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,93 @@
+/**
+ * @file        json_input_parser.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef JSON_INPUT_PARSER_H
+#define JSON_INPUT_PARSER_H
+
+#include <string>
+#include <map>
+#include <stdint.h>
+
+namespace Kitsunemimi
+{
+class DataItem;
+class DataMap;
+class DataArray;
+
+namespace Hanami
+{
+class Blossom;
+struct FieldDef;
+
+bool parseJsonInput(DataMap &result,
+                    const char* input,
+                    const uint64_t inputSize,
+                    const Blossom* blossom,
+                    std::string &errorMessage);
+
+class JsonInputParser
+{
+public:
+    JsonInputParser();
+
+    bool parse(DataMap &result,
+               const char* input,
+               const uint64_t inputSize,
+               const Blossom* blossom,
+               std::string &errorMessage);
+
+private:
+    const char* m_input = nullptr;
+    uint64_t m_inputSize = 0;
+    uint64_t m_pos = 0;
+    uint32_t m_depth = 0;
+    std::string* m_errorMessage = nullptr;
+
+    bool parseInputMap(DataMap &result,
+                       const std::map<std::string, FieldDef>* schema,
+                       const bool allowUnmatched);
+    bool checkFieldType(const std::string &name,
+                        const FieldDef &fieldDef);
+    bool checkFieldBorder(const std::string &name,
+                          const FieldDef &fieldDef,
+                          DataItem* item);
+    bool checkRequiredFields(const DataMap &result,
+                             const std::map<std::string, FieldDef>* schema);
+
+    bool parseValue(DataItem* &result);
+    bool parseMap(DataMap* result);
+    bool parseArray(DataArray* result);
+    bool parseString(std::string &result);
+    bool parseNumber(DataItem* &result);
+    bool parseLiteral(DataItem* &result);
+    bool parseUnicodeEscape(std::string &result);
+    bool parseHex(uint32_t &result);
+
+    void skipWhitespace();
+    bool consume(const char character);
+    bool setSyntaxError(const std::string &reason);
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // JSON_INPUT_PARSER_H
@@ -0,0 +1,183 @@
+/**
+ * @file        json_scanner.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef JSON_SCANNER_H
+#define JSON_SCANNER_H
+
+#include <stdint.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Scanning-functions for the json-parser, which check 32 (AVX2) or 16 (SSE2) bytes at once
+// and fall back to a byte-wise check for the tail of the input or on other architectures.
+// AVX2 is only used, when the library is compiled with -mavx2 or a matching -march-flag.
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief search the next character, which is not a json-whitespace
+ *
+ * @param input pointer to the input
+ * @param pos position to start the search
+ * @param size total size of the input
+ *
+ * @return position of the next non-whitespace character or size, if there is none
+ */
+inline uint64_t
+findNonWhitespace(const char* input,
+                  uint64_t pos,
+                  const uint64_t size)
+{
+#if defined(__AVX2__)
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i newLine = _mm256_set1_epi8('\n');
+    const __m256i carriageReturn = _mm256_set1_epi8('\r');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    while(pos + 32 <= size)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&input[pos]));
+        const __m256i isWhitespace = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, space),
+                                    _mm256_cmpeq_epi8(block, newLine)),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, carriageReturn),
+                                    _mm256_cmpeq_epi8(block, tab)));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(isWhitespace));
+        if(mask != 0) {
+            return pos + static_cast<uint64_t>(__builtin_ctz(mask));
+        }
+        pos += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i space128 = _mm_set1_epi8(' ');
+    const __m128i newLine128 = _mm_set1_epi8('\n');
+    const __m128i carriageReturn128 = _mm_set1_epi8('\r');
+    const __m128i tab128 = _mm_set1_epi8('\t');
+    while(pos + 16 <= size)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[pos]));
+        const __m128i isWhitespace = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(block, space128),
+                                 _mm_cmpeq_epi8(block, newLine128)),
+                    _mm_or_si128(_mm_cmpeq_epi8(block, carriageReturn128),
+                                 _mm_cmpeq_epi8(block, tab128)));
+        const uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(isWhitespace)) & 0xFFFF;
+        if(mask != 0) {
+            return pos + static_cast<uint64_t>(__builtin_ctz(mask));
+        }
+        pos += 16;
+    }
+#endif
+
+    while(pos < size)
+    {
+        const char character = input[pos];
+        if(character != ' '
+                && character != '\n'
+                && character != '\r'
+                && character != '\t')
+        {
+            return pos;
+        }
+        pos++;
+    }
+
+    return pos;
+}
+
+/**
+ * @brief search the next character within a string, which needs special handling, so the
+ *        closing quote, a backslash or a control-character
+ *
+ * @param input pointer to the input
+ * @param pos position to start the search
+ * @param size total size of the input
+ *
+ * @return position of the next special character or size, if there is none
+ */
+inline uint64_t
+findStringSpecial(const char* input,
+                  uint64_t pos,
+                  const uint64_t size)
+{
+#if defined(__AVX2__)
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+    while(pos + 32 <= size)
+    {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&input[pos]));
+        // unsigned min is equal to the byte itself, if the byte is a control-character
+        const __m256i isSpecial = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(block, quote),
+                                    _mm256_cmpeq_epi8(block, backslash)),
+                    _mm256_cmpeq_epi8(_mm256_min_epu8(block, control), block));
+        const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(isSpecial));
+        if(mask != 0) {
+            return pos + static_cast<uint64_t>(__builtin_ctz(mask));
+        }
+        pos += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i quote128 = _mm_set1_epi8('"');
+    const __m128i backslash128 = _mm_set1_epi8('\\');
+    const __m128i control128 = _mm_set1_epi8(0x1F);
+    while(pos + 16 <= size)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[pos]));
+        const __m128i isSpecial = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(block, quote128),
+                                 _mm_cmpeq_epi8(block, backslash128)),
+                    _mm_cmpeq_epi8(_mm_min_epu8(block, control128), block));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(isSpecial));
+        if(mask != 0) {
+            return pos + static_cast<uint64_t>(__builtin_ctz(mask));
+        }
+        pos += 16;
+    }
+#endif
+
+    while(pos < size)
+    {
+        const uint8_t character = static_cast<uint8_t>(input[pos]);
+        if(character == '"'
+                || character == '\\'
+                || character < 0x20)
+        {
+            return pos;
+        }
+        pos++;
+    }
+
+    return pos;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // JSON_SCANNER_H
@@ -31,11 +31,19 @@ namespace Kitsunemimi
 namespace Hanami
 {
 
+// response-type for requests, which are rejected by the rate-limiter, which is not part of the
+// HttpResponseTypes of the common library yet
+const HttpResponseTypes TOO_MANY_REQUESTS_RTYPE = static_cast<HttpResponseTypes>(429);
+
 enum MessageTypes
 {
     SAKURA_TRIGGER_MESSAGE = 0,
     SAKURA_GENERIC_MESSAGE = 1,
+    SAKURA_STREAM_CREDIT_MESSAGE = 2,
+    SAKURA_STREAM_COALESCING_MESSAGE = 3,
     RESPONSE_MESSAGE = 4,
+    SAKURA_SHARED_MEMORY_MESSAGE = 5,
+    SAKURA_TOKEN_TRIGGER_MESSAGE = 6,
 };
 
 struct SakuraTriggerHeader
@@ -46,6 +54,20 @@ struct SakuraTriggerHeader
     uint32_t inputValuesSize = 0;
 };
 
+/**
+ * @brief trigger-header with a separate token, which is identified by its own message-type.
+ *        Its layout begins like the SakuraTriggerHeader and only appends the token-size, so
+ *        triggers without separate token still use the old header and old peers are not broken.
+ */
+struct SakuraTokenTriggerHeader
+{
+    const uint8_t type = SAKURA_TOKEN_TRIGGER_MESSAGE;
+    HttpRequestType requestType = GET_TYPE;
+    uint32_t idSize = 0;
+    uint32_t inputValuesSize = 0;
+    uint32_t tokenSize = 0;
+};
+
 struct SakuraGenericHeader
 {
     const uint8_t type = SAKURA_GENERIC_MESSAGE;
@@ -53,6 +75,59 @@ struct SakuraGenericHeader
     uint32_t size = 0;
 };
 
+/**
+ * @brief get size of a generic message within a message, which contains multiple generic
+ *        messages. Each is padded, so the following header is aligned again.
+ *
+ * @param bodySize size of the body of the generic message
+ *
+ * @return size of header, body and padding
+ */
+inline uint64_t
+getGenericFrameSize(const uint64_t bodySize)
+{
+    const uint64_t size = sizeof(SakuraGenericHeader) + bodySize;
+    const uint64_t alignment = alignof(SakuraGenericHeader);
+    return ((size + alignment - 1) / alignment) * alignment;
+}
+
+/**
+ * @brief control-message for the flow-control of stream-messages. The sender enables the
+ *        flow-control with its window-size and the receiver grants the number of bytes,
+ *        which it has consumed, back to the sender.
+ */
+struct StreamCreditHeader
+{
+    const uint8_t type = SAKURA_STREAM_CREDIT_MESSAGE;
+    bool enable = false;
+    uint64_t credits = 0;
+};
+
+/**
+ * @brief control-message to inform the receiver, that all following stream-messages of the
+ *        session contain one or more records, which are prefixed by a StreamRecordHeader
+ */
+struct StreamCoalescingHeader
+{
+    const uint8_t type = SAKURA_STREAM_COALESCING_MESSAGE;
+};
+
+struct StreamRecordHeader
+{
+    uint32_t size = 0;
+};
+
+/**
+ * @brief control-message to offer a shared memory with a ring-buffer for stream-messages to a
+ *        receiver on the same host. The receiver answers with the same header and the result.
+ */
+struct SharedMemoryHeader
+{
+    const uint8_t type = SAKURA_SHARED_MEMORY_MESSAGE;
+    bool accept = false;
+    char name[64];
+};
+
 struct ResponseHeader
 {
     uint8_t type = RESPONSE_MESSAGE;
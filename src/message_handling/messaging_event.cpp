@@ -22,23 +22,24 @@
 
 #include "messaging_event.h"
 #include "permission.h"
+#include "rate_limiter.h"
+#include "error_log_shipper.h"
 
 #include <message_handling/message_definitions.h>
+#include <message_handling/json_frame_writer.h>
+#include <message_handling/json_input_parser.h>
 
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
 #include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+#include <libKitsunemimiHanamiNetwork/blossom.h>
 #include <libKitsunemimiHanamiCommon/component_support.h>
 
 #include <libKitsunemimiSakuraNetwork/session.h>
 
 #include <libKitsunemimiCommon/items/data_items.h>
 #include <libKitsunemimiCommon/logger.h>
-#include <libKitsunemimiJson/json_item.h>
 #include <libKitsunemimiCrypto/common.h>
 
-#include <../../libKitsunemimiHanamiMessages/protobuffers/shiori_messages.proto3.pb.h>
-#include <../../libKitsunemimiHanamiMessages/message_sub_types.h>
-
 namespace Kitsunemimi
 {
 namespace Hanami
@@ -46,52 +47,120 @@ namespace Hanami
 
 /**
  * @brief constructor
+ */
+MessagingEvent::MessagingEvent() {}
+
+/**
+ * @brief destructor
+ */
+MessagingEvent::~MessagingEvent() {}
+
+/**
+ * @brief fill event with the content of a new incoming message. The already allocated memory
+ *        of the internal strings is reused, if the event was already used before.
  *
- * @param targetId id of target to trigger
- * @param inputValues input-values as string
+ * @param httpType http-type of the request
+ * @param targetId pointer to the id of target to trigger
+ * @param targetIdSize size of the target-id
+ * @param token pointer to the token of the request-header
+ * @param tokenSize size of the token, which is 0, if the token is within the input-values
+ * @param inputValues pointer to the input-values as json-string
+ * @param inputValuesSize size of the input-values
  * @param session pointer to session to send the response back
  * @param blockerId blocker-id for the response
  */
-MessagingEvent::MessagingEvent(const HttpRequestType httpType,
-                               const std::string &targetId,
-                               const std::string &inputValues,
-                               Kitsunemimi::Sakura::Session* session,
-                               const uint64_t blockerId)
+void
+MessagingEvent::initEvent(const HttpRequestType httpType,
+                          const char* targetId,
+                          const uint32_t targetIdSize,
+                          const char* token,
+                          const uint32_t tokenSize,
+                          const char* inputValues,
+                          const uint64_t inputValuesSize,
+                          Kitsunemimi::Sakura::Session* session,
+                          const uint64_t blockerId)
 {
     m_httpType = httpType;
-    m_targetId = targetId;
-    m_inputValues = inputValues;
+    m_targetId.assign(targetId, targetIdSize);
+    m_token.assign(token, tokenSize);
+    m_inputValues.assign(inputValues, inputValuesSize);
     m_session = session;
     m_blockerId = blockerId;
 }
 
 /**
- * @brief destructor
+ * @brief reset event for the next usage. Buffers are only cleared and keep their memory, except
+ *        they became bigger than the limit, because of a single big message.
  */
-MessagingEvent::~MessagingEvent() {}
+void
+MessagingEvent::resetEvent()
+{
+    const uint64_t maxKeptBufferSize = 1024 * 1024;
+
+    m_httpType = GET_TYPE;
+    m_session = nullptr;
+    m_blockerId = 0;
+    m_targetId.clear();
+    m_token.clear();
+    m_endpoint.group.clear();
+    m_endpoint.name.clear();
+
+    m_inputValues.clear();
+    if(m_inputValues.capacity() > maxKeptBufferSize) {
+        std::string().swap(m_inputValues);
+    }
+
+    m_error.reset();
+    m_context.clear();
+    m_parsedInputValues.clear();
+    m_resultingItems.clear();
+    m_status.statusCode = 0;
+    m_status.errorMessage.clear();
+    m_errorMessage.clear();
+
+    m_responseFrame = nullptr;
+    m_responseFrameSize = 0;
+    m_arena.reset();
+}
 
 /**
- * @brief send reponse message with the results of the event
+ * @brief get response-message, which was created by the last request
+ *
+ * @return pointer to the response-message within the arena, nullptr if there is none
+ */
+const uint8_t*
+MessagingEvent::getResponseFrame() const
+{
+    return m_responseFrame;
+}
+
+/**
+ * @brief get size of the response-message, which was created by the last request
+ *
+ * @return size of the response-message in bytes
+ */
+uint64_t
+MessagingEvent::getResponseFrameSize() const
+{
+    return m_responseFrameSize;
+}
+
+/**
+ * @brief create reponse message with the results of the event
  *
  * @param success success-result of the event
  * @param responseType response http-type
  * @param message message to send over the response
- * @param session pointer to session to send the response back
- * @param blockerId blocker-id for the response
- * @param error reference for error-output
  */
 void
-MessagingEvent::sendResponseMessage(const bool success,
-                                    const HttpResponseTypes responseType,
-                                    const std::string &message,
-                                    Kitsunemimi::Sakura::Session* session,
-                                    const uint64_t blockerId,
-                                    ErrorContainer &error)
+MessagingEvent::createResponseMessage(const bool success,
+                                      const HttpResponseTypes responseType,
+                                      const std::string &message)
 {
-    // allocate memory to fill with the response-message
+    // get memory from the arena to fill with the response-message
     const uint32_t responseMessageSize = sizeof(ResponseHeader)
                                          + static_cast<uint32_t>(message.size());
-    uint8_t* buffer = new uint8_t[responseMessageSize];
+    uint8_t* buffer = static_cast<uint8_t*>(m_arena.allocate(responseMessageSize));
 
     // prepare response-header
     ResponseHeader responseHeader;
@@ -106,16 +175,36 @@ MessagingEvent::sendResponseMessage(const bool success,
     positionCounter += sizeof(ResponseHeader);
     memcpy(buffer + positionCounter, message.c_str(), message.size());
 
-    // send reponse over the session
-    session->sendResponse(buffer, responseMessageSize, blockerId, error);
+    m_responseFrame = buffer;
+    m_responseFrameSize = responseMessageSize;
+}
 
-    delete[] buffer;
+/**
+ * @brief create successful reponse message with the result of the event. The result is
+ *        serialized directly behind the reserved slot for the header into the frame.
+ *
+ * @param responseType response http-type
+ * @param resultingItems result of the event to send over the response
+ */
+void
+MessagingEvent::createResponseMessage(const HttpResponseTypes responseType,
+                                      DataMap &resultingItems)
+{
+    // serialize result into the frame
+    JsonFrameWriter writer(m_arena, sizeof(ResponseHeader));
+    writer.writeItem(&resultingItems);
+
+    // fill reserved header-slot
+    m_responseFrame = writer.finishResponseFrame(true, responseType);
+    m_responseFrameSize = writer.getFrameSize();
 }
 
 /**
  * @brief trigger remote blossom or tree
  *
  * @param resultingItems reference for the result of the trigger
+ * @param context context of the request, which is already filled, if the token was send within
+ *                the header of the request
  * @param inputValues input-values for the trigger
  * @param status reference for status-output
  * @param endpoint entpoint-entry to identify the target
@@ -125,39 +214,42 @@ MessagingEvent::sendResponseMessage(const bool success,
  */
 bool
 MessagingEvent::trigger(DataMap &resultingItems,
-                        JsonItem &inputValues,
+                        DataMap &context,
+                        DataMap &inputValues,
                         Hanami::BlossomStatus &status,
                         const EndpointEntry &endpoint,
                         ErrorContainer &error)
 {
-    DataMap context;
     HanamiMessaging* controller = HanamiMessaging::getInstance();
 
-    const std::string token = inputValues["token"].getString();
     // token is moved into the context object, so to not break the check of the input-fileds of the
     // blossoms, we have to remove this here again
-    // TODO: handle context in a separate field in the messaging
+    const std::string token = inputValues.getStringByKey("token");
     if(m_targetId != "v1/auth") {
         inputValues.remove("token");
     }
 
-    const bool skipPermission = m_session->m_sessionIdentifier != "torii"
-                                || m_targetId != "v1/auth"
-                                || m_targetId != "v1/token"
-                                || m_targetId != "v1/token/internal";
-
-    // check permission
-    if(checkPermission(context, token, status, skipPermission, error) == false)
+    // check permission, if the token was not already checked from the header of the request
+    if(m_token.size() == 0
+            && checkPermission(context, token, status, isPermissionSkipped(), error) == false)
     {
         status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
         return false;
     }
 
+    // check rate-limits of the user and the endpoint
+    if(RateLimiter::getInstance()->checkRequest(context.getStringByKey("id"), m_targetId) == false)
+    {
+        status.statusCode = TOO_MANY_REQUESTS_RTYPE;
+        status.errorMessage = "Too many requests";
+        return false;
+    }
+
     const bool ret = controller->triggerBlossom(resultingItems,
                                                 endpoint.name,
                                                 endpoint.group,
                                                 context,
-                                                *inputValues.getItemContent()->toMap(),
+                                                inputValues,
                                                 status,
                                                 error);
 
@@ -173,72 +265,113 @@ MessagingEvent::trigger(DataMap &resultingItems,
 }
 
 /**
- * @brief process messageing-event
+ * @brief check if the permission-check against misaki should be skipped for the request
+ *
+ * @return true, if only the token itself should be parsed, else false
+ */
+bool
+MessagingEvent::isPermissionSkipped() const
+{
+    // requests without session are processed locally and so they don't come from torii
+    if(m_session == nullptr) {
+        return true;
+    }
+
+    return m_session->m_sessionIdentifier != "torii"
+           || m_targetId != "v1/auth"
+           || m_targetId != "v1/token"
+           || m_targetId != "v1/token/internal";
+}
+
+/**
+ * @brief process messageing-event and send the response back over the session of the request
  *
  * @return true, if event was successful, else false
  */
 bool
 MessagingEvent::processEvent()
 {
-    ErrorContainer error;
+    const bool ret = handleRequest();
 
-    // parse json-formated input values
-    JsonItem inputValues;
-    if(inputValues.parse(m_inputValues, error) == false)
-    {
-        LOG_ERROR(error);
-        sendResponseMessage(false,
-                            BAD_REQUEST_RTYPE,
-                            error.toString(),
-                            m_session,
-                            m_blockerId,
-                            error);
-        return false;
+    if(m_responseFrame != nullptr) {
+        m_session->sendResponse(m_responseFrame, m_responseFrameSize, m_blockerId, m_error);
     }
 
+    return ret;
+}
+
+/**
+ * @brief handle the request of the event and create the response-message within the arena.
+ *        All state of the request is stored within the event, so it only has to be cleared
+ *        and not allocated again for the next request.
+ *
+ * @return true, if event was successful, else false
+ */
+bool
+MessagingEvent::handleRequest()
+{
+    HanamiMessaging* messaging = HanamiMessaging::getInstance();
+
     // get real endpoint
-    EndpointEntry entry;
-    bool ret = HanamiMessaging::getInstance()->mapEndpoint(entry, m_targetId, m_httpType);
+    bool ret = messaging->mapEndpoint(m_endpoint, m_targetId, m_httpType);
     if(ret == false)
     {
-        error.addMeesage("endpoint not found for id "
-                         + m_targetId
-                         + " and type "
-                         + std::to_string(m_httpType));
-        LOG_ERROR(error);
-        sendResponseMessage(false,
-                            NOT_IMPLEMENTED_RTYPE,
-                            error.toString(),
-                            m_session,
-                            m_blockerId,
-                            error);
+        m_error.addMeesage("endpoint not found for id "
+                           + m_targetId
+                           + " and type "
+                           + std::to_string(m_httpType));
+        LOG_ERROR(m_error);
+        createResponseMessage(false, NOT_IMPLEMENTED_RTYPE, m_error.toString());
         return false;
     }
 
-    // execute trigger
-    Hanami::BlossomStatus status;
-    DataMap resultingItems;
-    ret = trigger(resultingItems, inputValues, status, entry, error);
+    // get target-blossom to validate the input-values already while parsing them
+    Blossom* blossom = nullptr;
+    if(m_endpoint.type == BLOSSOM_TYPE) {
+        blossom = messaging->getBlossom(m_endpoint.group, m_endpoint.name);
+    }
 
-    // creating and send reposonse with the result of the event
-    const HttpResponseTypes type = static_cast<HttpResponseTypes>(status.statusCode);
-    if(ret)
+    // check permission already before parsing the input-values, if the token was send within
+    // the header of the request, so unauthorized requests are rejected without parsing
+    if(m_token.size() > 0
+            && checkPermission(m_context,
+                               m_token,
+                               m_status,
+                               isPermissionSkipped(),
+                               m_error) == false)
     {
-        sendResponseMessage(true,
-                            type,
-                            resultingItems.toString(),
-                            m_session,
-                            m_blockerId,
-                            error);
+        LOG_ERROR(m_error);
+        createResponseMessage(false, UNAUTHORIZED_RTYPE, m_status.errorMessage);
+        return false;
     }
-    else
+
+    // parse json-formated input values
+    if(parseJsonInput(m_parsedInputValues,
+                      m_inputValues.c_str(),
+                      m_inputValues.size(),
+                      blossom,
+                      m_errorMessage) == false)
     {
-        sendResponseMessage(false,
-                            type,
-                            status.errorMessage,
-                            m_session,
-                            m_blockerId,
-                            error);
+        m_error.addMeesage(m_errorMessage);
+        LOG_ERROR(m_error);
+        createResponseMessage(false, BAD_REQUEST_RTYPE, m_errorMessage);
+        return false;
+    }
+
+    // execute trigger
+    ret = trigger(m_resultingItems,
+                  m_context,
+                  m_parsedInputValues,
+                  m_status,
+                  m_endpoint,
+                  m_error);
+
+    // creating reposonse with the result of the event
+    const HttpResponseTypes type = static_cast<HttpResponseTypes>(m_status.statusCode);
+    if(ret) {
+        createResponseMessage(type, m_resultingItems);
+    } else {
+        createResponseMessage(false, type, m_status.errorMessage);
     }
 
     return true;
@@ -253,7 +386,7 @@ MessagingEvent::processEvent()
  */
 void
 MessagingEvent::sendErrorMessage(const DataMap &context,
-                                 const JsonItem &inputValues,
+                                 const DataMap &inputValues,
                                  const std::string &errorMessage)
 {
     // check if shiori is supported
@@ -268,36 +401,13 @@ MessagingEvent::sendErrorMessage(const DataMap &context,
         return;
     }
 
-    HanamiMessagingClient* client = HanamiMessaging::getInstance()->shioriClient;
-    if(client == nullptr) {
-        return;
-    }
-
-    // create binary for send
-    ErrorLog_Message msg;
-    msg.set_userid(userId);
-    msg.set_context(context.toString(true));
-    msg.set_values(inputValues.toString(true));
-    msg.set_component(SupportedComponents::getInstance()->localComponent);
-    msg.set_errormsg(errorMessage);
-
-    // serialize message
-    const uint64_t msgSize = msg.ByteSizeLong();
-    uint8_t* buffer = new uint8_t[msgSize];
-    if(msg.SerializeToArray(buffer, msgSize) == false) {
-        return;
-    }
-
-    // send message
-    Kitsunemimi::ErrorContainer error;
-    const bool ret = client->sendGenericMessage(SHIORI_ERROR_LOG_MESSAGE_TYPE,
-                                                buffer,
-                                                msgSize,
-                                                error);
-    delete[] buffer;
-    if(ret == false) {
-        return;
-    }
+    // the message is send in the background, together with other error-messages
+    ErrorLogEntry entry;
+    entry.userId = userId;
+    entry.context = context.toString(true);
+    entry.values = inputValues.toString(true);
+    entry.errorMessage = errorMessage;
+    ErrorLogShipper::getInstance()->addEntry(entry);
 }
 
 }  // namespace Hanami
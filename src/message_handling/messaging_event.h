@@ -25,29 +25,39 @@
 
 #include <libKitsunemimiCommon/threading/event.h>
 #include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiCommon/items/data_items.h>
 #include <libKitsunemimiHanamiCommon/structs.h>
 
+#include <message_handling/request_arena.h>
+
 namespace Kitsunemimi
 {
-class JsonItem;
-
 namespace Sakura {
 class Session;
 }
 namespace Hanami
 {
-struct BlossomStatus;
-
 class MessagingEvent
         : public Event
 {
 public:
-    MessagingEvent(const HttpRequestType httpType,
-                   const std::string &treeId,
-                   const std::string &inputValues,
+    MessagingEvent();
+    ~MessagingEvent();
+
+    void initEvent(const HttpRequestType httpType,
+                   const char* targetId,
+                   const uint32_t targetIdSize,
+                   const char* token,
+                   const uint32_t tokenSize,
+                   const char* inputValues,
+                   const uint64_t inputValuesSize,
                    Kitsunemimi::Sakura::Session* session,
                    const uint64_t blockerId);
-    ~MessagingEvent();
+    void resetEvent();
+
+    bool handleRequest();
+    const uint8_t* getResponseFrame() const;
+    uint64_t getResponseFrameSize() const;
 
 protected:
     bool processEvent();
@@ -56,23 +66,43 @@ private:
     uint64_t m_blockerId = 0;
     Kitsunemimi::Sakura::Session* m_session = nullptr;
     std::string m_targetId = "";
+    std::string m_token = "";
     std::string m_inputValues = "";
     HttpRequestType m_httpType = GET_TYPE;
 
-    void sendResponseMessage(const bool success,
-                             const HttpResponseTypes responseType,
-                             const std::string &message,
-                             Kitsunemimi::Sakura::Session* session,
-                             const uint64_t blockerId,
-                             ErrorContainer &error);
+    // buffers, which are kept over multiple usages of the event to avoid re-allocations
+    EndpointEntry m_endpoint;
+
+    // state of the request, which is only cleared between two usages of the event
+    ErrorContainer m_error;
+    DataMap m_context;
+    DataMap m_parsedInputValues;
+    DataMap m_resultingItems;
+    Hanami::BlossomStatus m_status;
+    std::string m_errorMessage = "";
+
+    // memory for all temporary buffers of the request, which is released at once at the end
+    RequestArena m_arena;
+
+    // response-message within the arena, which is send back at the end of the request
+    uint8_t* m_responseFrame = nullptr;
+    uint64_t m_responseFrameSize = 0;
+
+    void createResponseMessage(const bool success,
+                               const HttpResponseTypes responseType,
+                               const std::string &message);
+    void createResponseMessage(const HttpResponseTypes responseType,
+                               DataMap &resultingItems);
     bool trigger(DataMap &resultingItems,
-                 JsonItem &inputValues,
+                 DataMap &context,
+                 DataMap &inputValues,
                  Kitsunemimi::Hanami::BlossomStatus &status,
                  const EndpointEntry &endpoint,
                  ErrorContainer &error);
 
+    bool isPermissionSkipped() const;
     void sendErrorMessage(const DataMap &context,
-                          const JsonItem &inputValues,
+                          const DataMap &inputValues,
                           const std::string &errorMessage);
 };
 
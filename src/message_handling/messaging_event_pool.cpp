@@ -0,0 +1,120 @@
+/**
+ * @file        messaging_event_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "messaging_event_pool.h"
+
+#include <message_handling/messaging_event.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+Kitsunemimi::Hanami::MessagingEventPool* MessagingEventPool::m_instance = nullptr;
+
+// maximum number of unused events, which are hold by the pool. Events above this limit, for
+// example after a peak of incoming requests, are deleted again.
+const uint64_t MAX_NUMBER_OF_FREE_EVENTS = 1024;
+
+/**
+ * @brief constructor
+ */
+MessagingEventPool::MessagingEventPool()
+{
+    // reserve the full size, so the list itself never has to allocate new memory
+    m_freeEvents.reserve(MAX_NUMBER_OF_FREE_EVENTS);
+}
+
+/**
+ * @brief get instance of event-pool
+ *
+ * @return pointer to the instance of the event-pool
+ */
+MessagingEventPool*
+MessagingEventPool::getInstance()
+{
+    if(m_instance == nullptr) {
+        m_instance = new MessagingEventPool();
+    }
+
+    return m_instance;
+}
+
+/**
+ * @brief get an unused event from the pool or create a new one, if the pool is empty
+ *
+ * @return pointer to the event
+ */
+MessagingEvent*
+MessagingEventPool::getEvent()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_poolLock);
+
+        if(m_freeEvents.size() > 0)
+        {
+            MessagingEvent* event = m_freeEvents.back();
+            m_freeEvents.pop_back();
+            return event;
+        }
+    }
+
+    return new MessagingEvent();
+}
+
+/**
+ * @brief give a processed event back to the pool for the next incoming message
+ *
+ * @param event pointer to the event to release
+ */
+void
+MessagingEventPool::releaseEvent(MessagingEvent* event)
+{
+    event->resetEvent();
+
+    {
+        std::lock_guard<std::mutex> guard(m_poolLock);
+
+        if(m_freeEvents.size() < MAX_NUMBER_OF_FREE_EVENTS)
+        {
+            m_freeEvents.push_back(event);
+            return;
+        }
+    }
+
+    delete event;
+}
+
+/**
+ * @brief get number of unused events within the pool
+ *
+ * @return number of events
+ */
+uint64_t
+MessagingEventPool::getNumberOfFreeEvents()
+{
+    std::lock_guard<std::mutex> guard(m_poolLock);
+    return m_freeEvents.size();
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,57 @@
+/**
+ * @file        messaging_event_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MESSAGING_EVENT_POOL_H
+#define MESSAGING_EVENT_POOL_H
+
+#include <vector>
+#include <mutex>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+class MessagingEvent;
+
+class MessagingEventPool
+{
+public:
+    static MessagingEventPool* getInstance();
+
+    MessagingEvent* getEvent();
+    void releaseEvent(MessagingEvent* event);
+
+    uint64_t getNumberOfFreeEvents();
+
+private:
+    MessagingEventPool();
+
+    static MessagingEventPool* m_instance;
+
+    std::vector<MessagingEvent*> m_freeEvents;
+    std::mutex m_poolLock;
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // MESSAGING_EVENT_POOL_H
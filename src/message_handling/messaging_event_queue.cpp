@@ -22,9 +22,13 @@
 
 #include "messaging_event_queue.h"
 
+#include <chrono>
+
 #include <libKitsunemimiCommon/logger.h>
 
+#include <message_handling/messaging_event_worker.h>
 #include <message_handling/messaging_event.h>
+#include <message_handling/concurrency_limiter.h>
 
 namespace Kitsunemimi
 {
@@ -36,9 +40,11 @@ Kitsunemimi::Hanami::MessagingEventQueue* MessagingEventQueue::m_instance = null
 /**
  * @brief constructor
  */
-MessagingEventQueue::MessagingEventQueue(const std::string &threadName)
-    : Kitsunemimi::Thread(threadName)
-{}
+MessagingEventQueue::MessagingEventQueue()
+{
+    m_triggers.entries.resize(1024);
+    m_events.entries.resize(1024);
+}
 
 /**
  * @brief get instance of event-queue
@@ -48,37 +54,220 @@ MessagingEventQueue::MessagingEventQueue(const std::string &threadName)
 MessagingEventQueue*
 MessagingEventQueue::getInstance()
 {
-    if(m_instance == nullptr)
-    {
-        m_instance = new MessagingEventQueue("MessagingEventQueue");
-        m_instance->startThread();
+    if(m_instance == nullptr) {
+        m_instance = new MessagingEventQueue();
     }
 
     return m_instance;
 }
 
 /**
- * @brief run event-processing thread
+ * @brief create and start the worker-threads, which process the events of the queue. Multiple
+ *        worker allow to process further events, while a blossom is blocked by a request to
+ *        another component.
+ *
+ * @param numberOfWorker number of worker-threads, which is also the initial limit of triggers,
+ *                       which are processed at the same time
+ * @param maxNumberOfTriggers maximum number of triggers, which are processed at the same time
+ *
+ * @return false, if worker are already initialized or number is invalid, else true
+ */
+bool
+MessagingEventQueue::initWorker(const uint32_t numberOfWorker,
+                                const uint32_t maxNumberOfTriggers)
+{
+    std::lock_guard<std::mutex> guard(m_queueLock);
+
+    // precheck
+    if(m_worker.size() > 0
+            || numberOfWorker == 0
+            || maxNumberOfTriggers < numberOfWorker)
+    {
+        return false;
+    }
+
+    // create enough worker for the maximum number of triggers and keep additional worker for
+    // the other events, so these are never blocked by triggers
+    const uint32_t totalNumberOfWorker = maxNumberOfTriggers + numberOfWorker;
+    for(uint32_t i = 0; i < totalNumberOfWorker; i++)
+    {
+        MessagingEventWorker* worker = new MessagingEventWorker("MessagingEventWorker-"
+                                                                + std::to_string(i));
+        worker->startThread();
+        m_worker.push_back(worker);
+    }
+
+    ConcurrencyLimiter::getInstance()->setLimits(numberOfWorker, maxNumberOfTriggers);
+
+    return true;
+}
+
+/**
+ * @brief get number of initialized worker-threads
+ *
+ * @return number of worker
+ */
+uint32_t
+MessagingEventQueue::getNumberOfWorker()
+{
+    std::lock_guard<std::mutex> guard(m_queueLock);
+    return static_cast<uint32_t>(m_worker.size());
+}
+
+/**
+ * @brief add new event to the queue and wake up one of the waiting worker
+ *
+ * @param newEvent new event to add
  */
 void
-MessagingEventQueue::run()
+MessagingEventQueue::addEventToQueue(Event* newEvent)
 {
-    while(m_abort == false)
     {
-        // get event
-        Event* event = getEventFromQueue();
-        if(event == nullptr)
-        {
-            // sleep if no event exist in the queue
-            sleepThread(10000);
-        }
-        else
-        {
-            LOG_DEBUG("process messaging event");
-            event->processEvent();
-            delete event;
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        addToRing(m_events, newEvent);
+    }
+
+    m_queueCondition.notify_one();
+}
+
+/**
+ * @brief add new trigger to the queue and wake up one of the waiting worker
+ *
+ * @param newEvent new trigger-event to add
+ */
+void
+MessagingEventQueue::addTriggerToQueue(MessagingEvent* newEvent)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_queueLock);
+        addToRing(m_triggers, newEvent);
+    }
+
+    m_queueCondition.notify_one();
+}
+
+/**
+ * @brief get next event from the queue. Other events are preferred and triggers are only
+ *        returned, if the concurrency-limiter has a free slot for them.
+ *
+ * @param waitTime maximum time in microseconds to wait for a new event
+ * @param isTrigger reference for the output, if the event is a trigger, which holds a slot of
+ *                  the concurrency-limiter and has to be finished with finishTrigger
+ * @param queueWait reference for the time in microseconds, which the event waited in the queue
+ *
+ * @return nullptr, if queue is still empty after the wait-time, else pointer to the next event
+ */
+Event*
+MessagingEventQueue::getEventFromQueue(const uint32_t waitTime,
+                                       bool &isTrigger,
+                                       uint64_t &queueWait)
+{
+    std::unique_lock<std::mutex> lock(m_queueLock);
+
+    Event* event = takeNextEvent(isTrigger, queueWait);
+    if(event == nullptr)
+    {
+        m_queueCondition.wait_for(lock, std::chrono::microseconds(waitTime));
+        event = takeNextEvent(isTrigger, queueWait);
+    }
+
+    return event;
+}
+
+/**
+ * @brief give back the slot of a processed trigger and wake up a worker for the next trigger
+ *
+ * @param queueWait time in microseconds, which the trigger had waited in the queue
+ * @param latency processing-time of the trigger in microseconds
+ */
+void
+MessagingEventQueue::finishTrigger(const uint64_t queueWait,
+                                   const uint64_t latency)
+{
+    ConcurrencyLimiter::getInstance()->releaseSlot(queueWait, latency);
+    m_queueCondition.notify_one();
+}
+
+/**
+ * @brief add event to a ring-buffer, which must be called with locked mutex
+ *
+ * @param ring ring-buffer to extend
+ * @param newEvent new event to add
+ */
+void
+MessagingEventQueue::addToRing(EventRing &ring,
+                               Event* newEvent)
+{
+    // double the size of the ring-buffer, if full
+    if(ring.numberOfEvents == ring.entries.size())
+    {
+        std::vector<QueueEntry> newEntries(ring.entries.size() * 2);
+        for(uint64_t i = 0; i < ring.numberOfEvents; i++) {
+            newEntries[i] = ring.entries[(ring.start + i) % ring.entries.size()];
         }
+        ring.entries.swap(newEntries);
+        ring.start = 0;
+    }
+
+    QueueEntry* entry = &ring.entries[(ring.start + ring.numberOfEvents) % ring.entries.size()];
+    entry->event = newEvent;
+    entry->addTime = std::chrono::steady_clock::now();
+    ring.numberOfEvents++;
+}
+
+/**
+ * @brief take the oldest event from a ring-buffer, which must be called with locked mutex
+ *
+ * @param ring ring-buffer to read from
+ * @param queueWait reference for the time in microseconds, which the event waited in the queue
+ *
+ * @return pointer to the event
+ */
+Event*
+MessagingEventQueue::takeFromRing(EventRing &ring,
+                                  uint64_t &queueWait)
+{
+    QueueEntry* entry = &ring.entries[ring.start];
+    Event* event = entry->event;
+    const std::chrono::steady_clock::duration waitTime = std::chrono::steady_clock::now()
+                                                         - entry->addTime;
+    queueWait = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(waitTime).count());
+
+    entry->event = nullptr;
+    ring.start = (ring.start + 1) % ring.entries.size();
+    ring.numberOfEvents--;
+
+    return event;
+}
+
+/**
+ * @brief get next processable event, which must be called with locked mutex
+ *
+ * @param isTrigger reference for the output, if the event is a trigger
+ * @param queueWait reference for the time in microseconds, which the event waited in the queue
+ *
+ * @return nullptr, if no event can be processed at the moment, else pointer to the next event
+ */
+Event*
+MessagingEventQueue::takeNextEvent(bool &isTrigger,
+                                   uint64_t &queueWait)
+{
+    // other events, like multicast-helper or generic handler, are not limited
+    if(m_events.numberOfEvents > 0)
+    {
+        isTrigger = false;
+        return takeFromRing(m_events, queueWait);
     }
+
+    if(m_triggers.numberOfEvents > 0
+            && ConcurrencyLimiter::getInstance()->tryAcquireSlot())
+    {
+        isTrigger = true;
+        return takeFromRing(m_triggers, queueWait);
+    }
+
+    return nullptr;
 }
 
 }  // namespace Hanami
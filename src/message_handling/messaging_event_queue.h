@@ -23,26 +23,66 @@
 #ifndef MESSAGING_EVENT_QUEUE_H
 #define MESSAGING_EVENT_QUEUE_H
 
-#include <libKitsunemimiCommon/threading/thread.h>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/event.h>
 
 namespace Kitsunemimi
 {
 namespace Hanami
 {
+class MessagingEventWorker;
+class MessagingEvent;
 
 class MessagingEventQueue
-        : public Kitsunemimi::Thread
 {
 public:  
     static MessagingEventQueue* getInstance();
 
-protected:
-    void run();
+    bool initWorker(const uint32_t numberOfWorker,
+                    const uint32_t maxNumberOfTriggers);
+    uint32_t getNumberOfWorker();
+
+    void addEventToQueue(Event* newEvent);
+    void addTriggerToQueue(MessagingEvent* newEvent);
+    Event* getEventFromQueue(const uint32_t waitTime,
+                             bool &isTrigger,
+                             uint64_t &queueWait);
+    void finishTrigger(const uint64_t queueWait, const uint64_t latency);
 
 private:
-    MessagingEventQueue(const std::string &threadName);
+    MessagingEventQueue();
+
+    struct QueueEntry
+    {
+        Event* event = nullptr;
+        std::chrono::steady_clock::time_point addTime;
+    };
+
+    // ring-buffer, which only grows and never shrinks, to avoid allocations in normal operation
+    struct EventRing
+    {
+        std::vector<QueueEntry> entries;
+        uint64_t start = 0;
+        uint64_t numberOfEvents = 0;
+    };
 
     static MessagingEventQueue* m_instance;
+
+    // triggers are limited by the concurrency-limiter, all other events not
+    EventRing m_triggers;
+    EventRing m_events;
+    std::mutex m_queueLock;
+    std::condition_variable m_queueCondition;
+
+    std::vector<MessagingEventWorker*> m_worker;
+
+    void addToRing(EventRing &ring, Event* newEvent);
+    Event* takeFromRing(EventRing &ring, uint64_t &queueWait);
+    Event* takeNextEvent(bool &isTrigger, uint64_t &queueWait);
 };
 
 }  // namespace Hanami
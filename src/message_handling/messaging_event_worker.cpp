@@ -0,0 +1,88 @@
+/**
+ * @file        messaging_event_worker.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "messaging_event_worker.h"
+
+#include <chrono>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#include <message_handling/messaging_event_queue.h>
+#include <message_handling/messaging_event_pool.h>
+#include <message_handling/messaging_event.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ *
+ * @param threadName name of the worker-thread
+ */
+MessagingEventWorker::MessagingEventWorker(const std::string &threadName)
+    : Kitsunemimi::Thread(threadName) {}
+
+/**
+ * @brief run event-processing thread
+ */
+void
+MessagingEventWorker::run()
+{
+    MessagingEventQueue* queue = MessagingEventQueue::getInstance();
+    MessagingEventPool* pool = MessagingEventPool::getInstance();
+
+    while(m_abort == false)
+    {
+        // get event and wait up to 10ms, if no event exist in the queue or all slots for
+        // triggers are in use
+        bool isTrigger = false;
+        uint64_t queueWait = 0;
+        Event* event = queue->getEventFromQueue(10000, isTrigger, queueWait);
+        if(event == nullptr) {
+            continue;
+        }
+
+        if(isTrigger)
+        {
+            // only triggers use a slot of the limiter and their timings adjust the limit
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            event->processEvent();
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            const uint64_t latency = static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+            queue->finishTrigger(queueWait, latency);
+
+            // give messaging-events back to the pool for reuse
+            pool->releaseEvent(static_cast<MessagingEvent*>(event));
+        }
+        else
+        {
+            event->processEvent();
+            delete event;
+        }
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
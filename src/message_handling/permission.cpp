@@ -22,6 +22,8 @@
 
 #include "permission.h"
 
+#include <message_handling/json_input_parser.h>
+
 #include <libKitsunemimiHanamiCommon/component_support.h>
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
 #include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
@@ -39,6 +41,137 @@ namespace Kitsunemimi
 {
 namespace Hanami
 {
+
+// permission-requests, which are currently in progress, with the token as key
+std::map<std::string, PermissionRequest*> g_runningPermissionRequests;
+std::mutex g_runningPermissionRequestsLock;
+
+// tokens, which were rejected by misaki, with the token itself as key, because with a hash a
+// collision would reject a valid token
+const uint64_t MAX_NUMBER_OF_REJECTED_TOKENS = 100000;
+std::map<std::string, RejectedToken> g_rejectedTokens;
+std::mutex g_rejectedTokensLock;
+std::atomic<uint32_t> g_rejectedTokenCacheTime(10);
+std::atomic<uint64_t> g_rejectedTokenCacheHits(0);
+std::atomic<uint64_t> g_rejectedTokenCacheMisses(0);
+
+/**
+ * @brief set time, how long a rejected token is directly rejected again without asking misaki
+ *
+ * @param seconds time in seconds, 0 to disable the cache
+ */
+void
+setRejectedTokenCacheTime(const uint32_t seconds)
+{
+    g_rejectedTokenCacheTime = seconds;
+}
+
+/**
+ * @brief get number of requests, which were rejected based on the cache of rejected tokens
+ *
+ * @return number of hits
+ */
+uint64_t
+getNumberOfRejectedTokenCacheHits()
+{
+    return g_rejectedTokenCacheHits;
+}
+
+/**
+ * @brief get number of requests, which were not found in the cache of rejected tokens
+ *
+ * @return number of misses
+ */
+uint64_t
+getNumberOfRejectedTokenCacheMisses()
+{
+    return g_rejectedTokenCacheMisses;
+}
+
+/**
+ * @brief check if a token was rejected by misaki a short time ago
+ *
+ * @param token token to check
+ * @param status reference for status-output, which is filled, if the token was found
+ *
+ * @return true, if token was found in the cache, else false
+ */
+bool
+getRejectedToken(const std::string &token,
+                 Hanami::BlossomStatus &status)
+{
+    if(g_rejectedTokenCacheTime == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(g_rejectedTokensLock);
+
+    std::map<std::string, RejectedToken>::iterator it;
+    it = g_rejectedTokens.find(token);
+    if(it == g_rejectedTokens.end())
+    {
+        g_rejectedTokenCacheMisses++;
+        return false;
+    }
+
+    // remove outdated entry
+    if(it->second.expireTime < std::chrono::steady_clock::now())
+    {
+        g_rejectedTokens.erase(it);
+        g_rejectedTokenCacheMisses++;
+        return false;
+    }
+
+    status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+    status.errorMessage = it->second.errorMessage;
+    g_rejectedTokenCacheHits++;
+
+    return true;
+}
+
+/**
+ * @brief add token, which was rejected by misaki, to the cache
+ *
+ * @param token rejected token
+ * @param errorMessage error-message of misaki to send for requests with the same token
+ */
+void
+addRejectedToken(const std::string &token,
+                 const std::string &errorMessage)
+{
+    const uint32_t cacheTime = g_rejectedTokenCacheTime;
+    if(cacheTime == 0) {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> guard(g_rejectedTokensLock);
+
+    // remove outdated entries, when the cache becomes full
+    if(g_rejectedTokens.size() >= MAX_NUMBER_OF_REJECTED_TOKENS)
+    {
+        std::map<std::string, RejectedToken>::iterator it;
+        for(it = g_rejectedTokens.begin(); it != g_rejectedTokens.end();)
+        {
+            if(it->second.expireTime < now) {
+                it = g_rejectedTokens.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        // if there are still too many, the cache is only a protection and can be dropped
+        if(g_rejectedTokens.size() >= MAX_NUMBER_OF_REJECTED_TOKENS) {
+            g_rejectedTokens.clear();
+        }
+    }
+
+    RejectedToken rejectedToken;
+    rejectedToken.expireTime = now + std::chrono::seconds(cacheTime);
+    rejectedToken.errorMessage = errorMessage;
+    g_rejectedTokens[token] = rejectedToken;
+}
+
 /**
  * @brief check if a token is valid and parse the token
  *
@@ -57,8 +190,6 @@ checkPermission(DataMap &context,
                 const bool skipPermission,
                 Kitsunemimi::ErrorContainer &error)
 {
-    JsonItem parsedResult;
-
     // only get token content without validation, if misaki is not supported
     if(skipPermission)
     {
@@ -66,11 +197,14 @@ checkPermission(DataMap &context,
             return true;
         }
 
+        JsonItem parsedResult;
         if(getJwtTokenPayload(parsedResult, token, error) == false)
         {
             status.statusCode = Kitsunemimi::Hanami::BAD_REQUEST_RTYPE;
             return false;
         }
+
+        context = *parsedResult.getItemContent()->toMap();
     }
     else
     {
@@ -83,7 +217,7 @@ checkPermission(DataMap &context,
             return false;
         }
 
-        if(getPermission(parsedResult, token, status, error) == false)
+        if(getPermission(context, token, status, error) == false)
         {
             status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
             return false;
@@ -91,14 +225,15 @@ checkPermission(DataMap &context,
     }
 
     // fill context-object
-    context = *parsedResult.getItemContent()->toMap();
     context.insert("token", new DataValue(token));
 
     return true;
 }
 
 /**
- * @brief send request to misaki to check and parse a jwt-token
+ * @brief check and parse a jwt-token with misaki. If there is already a running request for the
+ *        same token, no new request is send to misaki, but the result of the running one is used.
+ *        Tokens, which were rejected a short time ago, are rejected directly.
  *
  * @param parsedResult reference for the parsed result
  * @param token token to check and to parse
@@ -108,12 +243,115 @@ checkPermission(DataMap &context,
  * @return true, if successful, else false
  */
 bool
-getPermission(JsonItem &parsedResult,
+getPermission(DataMap &parsedResult,
               const std::string &token,
               Hanami::BlossomStatus &status,
               ErrorContainer &error)
 {
-    Kitsunemimi::Hanami::ResponseMessage responseMsg;
+    // reject tokens, which were rejected by misaki a short time ago, directly
+    if(getRejectedToken(token, status))
+    {
+        error.addMeesage("Token was already rejected before");
+        return false;
+    }
+
+    PermissionRequest* request = nullptr;
+    bool isCreator = false;
+
+    // join running request or register a new one
+    {
+        std::lock_guard<std::mutex> guard(g_runningPermissionRequestsLock);
+
+        std::map<std::string, PermissionRequest*>::iterator it;
+        it = g_runningPermissionRequests.find(token);
+        if(it != g_runningPermissionRequests.end())
+        {
+            request = it->second;
+            request->references++;
+        }
+        else
+        {
+            request = new PermissionRequest();
+            g_runningPermissionRequests.emplace(token, request);
+            isCreator = true;
+        }
+    }
+
+    if(isCreator)
+    {
+        // send the request to misaki
+        ErrorContainer requestError;
+        Hanami::BlossomStatus requestStatus;
+        const bool ret = requestPermission(request->result, token, requestStatus, requestError);
+        if(ret == false
+                && requestStatus.statusCode == Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE)
+        {
+            addRejectedToken(token, requestStatus.errorMessage);
+        }
+
+        // remove from the list, so following requests trigger a new check
+        {
+            std::lock_guard<std::mutex> guard(g_runningPermissionRequestsLock);
+            g_runningPermissionRequests.erase(token);
+        }
+
+        // publish result to all waiting requests
+        {
+            std::lock_guard<std::mutex> guard(request->lock);
+            request->success = ret;
+            request->statusCode = requestStatus.statusCode;
+            request->statusMessage = requestStatus.errorMessage;
+            if(ret == false) {
+                request->errorMessage = requestError.toString();
+            }
+            request->finished = true;
+        }
+        request->finishedCondition.notify_all();
+    }
+    else
+    {
+        // wait for the result of the running request
+        std::unique_lock<std::mutex> guard(request->lock);
+        request->finishedCondition.wait(guard, [request]{ return request->finished; });
+    }
+
+    // take over result
+    const bool success = request->success;
+    if(success)
+    {
+        parsedResult = request->result;
+    }
+    else
+    {
+        status.statusCode = request->statusCode;
+        status.errorMessage = request->statusMessage;
+        error.addMeesage(request->errorMessage);
+    }
+
+    if(request->references.fetch_sub(1) == 1) {
+        delete request;
+    }
+
+    return success;
+}
+
+/**
+ * @brief send request to misaki to check and parse a jwt-token
+ *
+ * @param parsedResult reference for the parsed result
+ * @param token token to check and to parse
+ * @param status reference for status-output
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+requestPermission(DataMap &parsedResult,
+                  const std::string &token,
+                  Hanami::BlossomStatus &status,
+                  ErrorContainer &error)
+{
+    Kitsunemimi::Hanami::BufferedResponseMessage responseMsg;
     Hanami::HanamiMessaging* messaging = Hanami::HanamiMessaging::getInstance();
 
     // create request
@@ -142,13 +380,20 @@ getPermission(JsonItem &parsedResult,
             || responseMsg.success == false)
     {
         status.statusCode = responseMsg.type;
-        status.errorMessage = responseMsg.responseContent;
-        error.addMeesage(responseMsg.responseContent);
+        status.errorMessage = std::string(responseMsg.getContent());
+        error.addMeesage(status.errorMessage);
         return false;
     }
 
-    if(parsedResult.parse(responseMsg.responseContent, error) == false)
+    // parse response directly out of the received buffer
+    std::string errorMessage;
+    if(parseJsonInput(parsedResult,
+                      responseMsg.getContentData(),
+                      responseMsg.getContentSize(),
+                      nullptr,
+                      errorMessage) == false)
     {
+        error.addMeesage(errorMessage);
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         error.addMeesage("Unable to parse auth-reponse.");
         return false;
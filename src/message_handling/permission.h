@@ -23,29 +23,76 @@
 #ifndef PERMISSION_H
 #define PERMISSION_H
 
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <map>
+#include <chrono>
+
 #include <libKitsunemimiCommon/threading/event.h>
 #include <libKitsunemimiHanamiCommon/structs.h>
 #include <libKitsunemimiCommon/logger.h>
 
 namespace Kitsunemimi
 {
-class JsonItem;
-
 namespace Hanami
 {
 struct BlossomStatus;
 
+/**
+ * @brief running permission-request against misaki, which is shared by all requests with the
+ *        same token, which arrive while it is in progress
+ */
+struct PermissionRequest
+{
+    std::mutex lock;
+    std::condition_variable finishedCondition;
+    bool finished = false;
+
+    bool success = false;
+    DataMap result;
+    uint64_t statusCode = 0;
+    std::string statusMessage = "";
+    std::string errorMessage = "";
+
+    // the creator and all waiting requests, the last one deletes the object
+    std::atomic<uint32_t> references{1};
+};
+
+/**
+ * @brief token, which was rejected by misaki
+ */
+struct RejectedToken
+{
+    std::chrono::steady_clock::time_point expireTime;
+    std::string errorMessage = "";
+};
+
+void setRejectedTokenCacheTime(const uint32_t seconds);
+uint64_t getNumberOfRejectedTokenCacheHits();
+uint64_t getNumberOfRejectedTokenCacheMisses();
+
 bool checkPermission(DataMap &context,
                      const std::string &token,
                      Kitsunemimi::Hanami::BlossomStatus &status,
                      const bool skipPermission,
                      Kitsunemimi::ErrorContainer &error);
 
-bool getPermission(JsonItem &parsedResult,
+bool getPermission(DataMap &parsedResult,
                    const std::string &token,
                    Kitsunemimi::Hanami::BlossomStatus &status,
                    Kitsunemimi::ErrorContainer &error);
 
+bool getRejectedToken(const std::string &token,
+                      Kitsunemimi::Hanami::BlossomStatus &status);
+void addRejectedToken(const std::string &token,
+                      const std::string &errorMessage);
+
+bool requestPermission(DataMap &parsedResult,
+                       const std::string &token,
+                       Kitsunemimi::Hanami::BlossomStatus &status,
+                       Kitsunemimi::ErrorContainer &error);
+
 }  // namespace Hanami
 }  // namespace Kitsunemimi
 
@@ -0,0 +1,246 @@
+/**
+ * @file        rate_limiter.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "rate_limiter.h"
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+Kitsunemimi::Hanami::RateLimiter* RateLimiter::m_instance = nullptr;
+
+// maximum number of buckets per type. Above this limit, all full buckets are removed, because
+// they belong to users or endpoints, which were not active for a while. This is done at most
+// once per cleanup-interval and new keys use the overflow-bucket, until there is space again.
+const uint64_t MAX_NUMBER_OF_BUCKETS = 100000;
+const std::chrono::seconds BUCKET_CLEANUP_INTERVAL(1);
+
+/**
+ * @brief constructor
+ */
+RateLimiter::RateLimiter() {}
+
+/**
+ * @brief get instance of the rate-limiter
+ *
+ * @return pointer to the instance of the rate-limiter
+ */
+RateLimiter*
+RateLimiter::getInstance()
+{
+    if(m_instance == nullptr) {
+        m_instance = new RateLimiter();
+    }
+
+    return m_instance;
+}
+
+/**
+ * @brief set limit for the requests of a single user
+ *
+ * @param requestsPerSecond number of requests per second, which are refilled; 0 to disable
+ * @param burstSize maximum number of requests, which can be done at once
+ */
+void
+RateLimiter::setUserLimit(const double requestsPerSecond,
+                          const uint32_t burstSize)
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+
+    m_userLimit.requestsPerSecond = requestsPerSecond;
+    m_userLimit.burstSize = burstSize;
+    m_userBuckets = BucketMap();
+}
+
+/**
+ * @brief set limit for the requests of a single endpoint
+ *
+ * @param requestsPerSecond number of requests per second, which are refilled; 0 to disable
+ * @param burstSize maximum number of requests, which can be done at once
+ */
+void
+RateLimiter::setEndpointLimit(const double requestsPerSecond,
+                              const uint32_t burstSize)
+{
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+
+    m_endpointLimit.requestsPerSecond = requestsPerSecond;
+    m_endpointLimit.burstSize = burstSize;
+    m_endpointBuckets = BucketMap();
+}
+
+/**
+ * @brief check if a request is within the limits of the user and the endpoint. A token is only
+ *        taken from both buckets, if both have one left, so a rejected request doesn't reduce
+ *        the limit of the other one.
+ *
+ * @param userId id of the user, who sends the request, or empty string if unknown
+ * @param endpoint endpoint, which is requested
+ *
+ * @return true, if the request is allowed, false if over the limit
+ */
+bool
+RateLimiter::checkRequest(const std::string &userId,
+                          const std::string &endpoint)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> guard(m_limiterLock);
+
+    TokenBucket* userBucket = nullptr;
+    if(userId != "") {
+        userBucket = getBucket(m_userBuckets, userId, m_userLimit, now);
+    }
+    TokenBucket* endpointBucket = getBucket(m_endpointBuckets, endpoint, m_endpointLimit, now);
+
+    if(userBucket != nullptr
+            && userBucket->numberOfTokens < 1.0)
+    {
+        return false;
+    }
+
+    if(endpointBucket != nullptr
+            && endpointBucket->numberOfTokens < 1.0)
+    {
+        return false;
+    }
+
+    if(userBucket != nullptr) {
+        userBucket->numberOfTokens -= 1.0;
+    }
+    if(endpointBucket != nullptr) {
+        endpointBucket->numberOfTokens -= 1.0;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get bucket for a key and refill it based on the time since the last request
+ *
+ * @param bucketMap all buckets of the type
+ * @param key user-id or endpoint
+ * @param limit limit for the type
+ * @param now current time
+ *
+ * @return pointer to the refilled bucket, nullptr if the limit is disabled
+ */
+RateLimiter::TokenBucket*
+RateLimiter::getBucket(BucketMap &bucketMap,
+                       const std::string &key,
+                       const Limit &limit,
+                       const std::chrono::steady_clock::time_point &now)
+{
+    if(limit.requestsPerSecond <= 0.0
+            || limit.burstSize == 0)
+    {
+        return nullptr;
+    }
+
+    std::map<std::string, TokenBucket>::iterator it;
+    it = bucketMap.buckets.find(key);
+    if(it != bucketMap.buckets.end())
+    {
+        refillBucket(it->second, limit, now);
+        return &it->second;
+    }
+
+    // remove buckets of inactive users or endpoints
+    if(bucketMap.buckets.size() >= MAX_NUMBER_OF_BUCKETS
+            && now - bucketMap.lastCleanup >= BUCKET_CLEANUP_INTERVAL)
+    {
+        removeFullBuckets(bucketMap, limit, now);
+    }
+
+    // all new keys share one bucket, while the map is full
+    if(bucketMap.buckets.size() >= MAX_NUMBER_OF_BUCKETS)
+    {
+        if(bucketMap.overflowInit == false)
+        {
+            bucketMap.overflowBucket.numberOfTokens = static_cast<double>(limit.burstSize);
+            bucketMap.overflowBucket.lastUpdate = now;
+            bucketMap.overflowInit = true;
+        }
+        refillBucket(bucketMap.overflowBucket, limit, now);
+        return &bucketMap.overflowBucket;
+    }
+
+    TokenBucket newBucket;
+    newBucket.numberOfTokens = static_cast<double>(limit.burstSize);
+    newBucket.lastUpdate = now;
+    it = bucketMap.buckets.emplace(key, newBucket).first;
+
+    return &it->second;
+}
+
+/**
+ * @brief refill bucket based on the time since the last request
+ *
+ * @param bucket bucket to refill
+ * @param limit limit for the type of the bucket
+ * @param now current time
+ */
+void
+RateLimiter::refillBucket(TokenBucket &bucket,
+                          const Limit &limit,
+                          const std::chrono::steady_clock::time_point &now)
+{
+    const double burstSize = static_cast<double>(limit.burstSize);
+    const double seconds = std::chrono::duration<double>(now - bucket.lastUpdate).count();
+    bucket.numberOfTokens += seconds * limit.requestsPerSecond;
+    if(bucket.numberOfTokens > burstSize) {
+        bucket.numberOfTokens = burstSize;
+    }
+    bucket.lastUpdate = now;
+}
+
+/**
+ * @brief remove all buckets, which would be full again, because they were not used for a while
+ *
+ * @param bucketMap all buckets of the type
+ * @param limit limit for the type
+ * @param now current time
+ */
+void
+RateLimiter::removeFullBuckets(BucketMap &bucketMap,
+                               const Limit &limit,
+                               const std::chrono::steady_clock::time_point &now)
+{
+    const double burstSize = static_cast<double>(limit.burstSize);
+    bucketMap.lastCleanup = now;
+
+    std::map<std::string, TokenBucket>::iterator it;
+    for(it = bucketMap.buckets.begin(); it != bucketMap.buckets.end();)
+    {
+        const TokenBucket &bucket = it->second;
+        const std::chrono::duration<double> idleTime = now - bucket.lastUpdate;
+        const double refill = idleTime.count() * limit.requestsPerSecond;
+        if(bucket.numberOfTokens + refill >= burstSize) {
+            it = bucketMap.buckets.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
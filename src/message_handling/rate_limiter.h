@@ -0,0 +1,95 @@
+/**
+ * @file        rate_limiter.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class RateLimiter
+{
+public:
+    static RateLimiter* getInstance();
+
+    void setUserLimit(const double requestsPerSecond, const uint32_t burstSize);
+    void setEndpointLimit(const double requestsPerSecond, const uint32_t burstSize);
+
+    bool checkRequest(const std::string &userId,
+                      const std::string &endpoint);
+
+private:
+    RateLimiter();
+
+    static RateLimiter* m_instance;
+
+    struct TokenBucket
+    {
+        double numberOfTokens = 0.0;
+        std::chrono::steady_clock::time_point lastUpdate;
+    };
+
+    struct Limit
+    {
+        double requestsPerSecond = 0.0;
+        uint32_t burstSize = 0;
+    };
+
+    // buckets of one type. If the map is full, new keys share the overflow-bucket, so the
+    // number of buckets is a hard limit, even with many different keys.
+    struct BucketMap
+    {
+        std::map<std::string, TokenBucket> buckets;
+        TokenBucket overflowBucket;
+        bool overflowInit = false;
+        std::chrono::steady_clock::time_point lastCleanup;
+    };
+
+    Limit m_userLimit;
+    Limit m_endpointLimit;
+    BucketMap m_userBuckets;
+    BucketMap m_endpointBuckets;
+    std::mutex m_limiterLock;
+
+    TokenBucket* getBucket(BucketMap &bucketMap,
+                           const std::string &key,
+                           const Limit &limit,
+                           const std::chrono::steady_clock::time_point &now);
+    void refillBucket(TokenBucket &bucket,
+                      const Limit &limit,
+                      const std::chrono::steady_clock::time_point &now);
+    void removeFullBuckets(BucketMap &bucketMap,
+                           const Limit &limit,
+                           const std::chrono::steady_clock::time_point &now);
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // RATE_LIMITER_H
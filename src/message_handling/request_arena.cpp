@@ -0,0 +1,209 @@
+/**
+ * @file        request_arena.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "request_arena.h"
+
+#include <string.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// alignment of all allocations within the arena
+const uint64_t ARENA_ALIGNMENT = 16;
+
+// maximum amount of memory, which is kept by the arena after a reset. Blocks above this limit
+// were only necessary for a single very big request and are freed again.
+const uint64_t MAX_KEPT_ARENA_SIZE = 1024 * 1024;
+
+/**
+ * @brief constructor
+ *
+ * @param blockSize default-size of a memory-block of the arena
+ */
+RequestArena::RequestArena(const uint64_t blockSize)
+{
+    m_blockSize = blockSize;
+    m_blocks.reserve(16);
+}
+
+/**
+ * @brief destructor
+ */
+RequestArena::~RequestArena()
+{
+    for(ArenaBlock &block : m_blocks) {
+        delete[] block.data;
+    }
+}
+
+/**
+ * @brief get memory from the arena. The memory is only valid until the next reset of the arena
+ *        and must not be freed separately.
+ *
+ * @param size number of bytes to allocate
+ *
+ * @return pointer to the allocated memory
+ */
+void*
+RequestArena::allocate(const uint64_t size)
+{
+    // try to place allocation within the active block
+    if(m_activeBlock < m_blocks.size())
+    {
+        const uint64_t alignedPos = (m_blockPos + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+        if(alignedPos + size <= m_blocks[m_activeBlock].size)
+        {
+            m_blockPos = alignedPos + size;
+            m_usedSize += size;
+            return &m_blocks[m_activeBlock].data[alignedPos];
+        }
+
+        m_activeBlock++;
+    }
+
+    // search for the next already existing block, which is big enough
+    while(m_activeBlock < m_blocks.size())
+    {
+        if(m_blocks[m_activeBlock].size >= size)
+        {
+            m_blockPos = size;
+            m_usedSize += size;
+            return m_blocks[m_activeBlock].data;
+        }
+
+        m_activeBlock++;
+    }
+
+    // create new block, which is at least as big as the requested memory
+    ArenaBlock newBlock;
+    newBlock.size = size > m_blockSize ? size : m_blockSize;
+    newBlock.data = new uint8_t[newBlock.size];
+    m_blocks.push_back(newBlock);
+    m_reservedSize += newBlock.size;
+
+    m_activeBlock = m_blocks.size() - 1;
+    m_blockPos = size;
+    m_usedSize += size;
+
+    return newBlock.data;
+}
+
+/**
+ * @brief resize a memory-section of the arena. If the section is the last allocation of the
+ *        active block and the block is big enough, it is resized in-place, else a new section
+ *        is allocated and the old content is copied.
+ *
+ * @param ptr pointer to the memory-section to resize
+ * @param oldSize old size of the memory-section
+ * @param newSize requested new size of the memory-section
+ *
+ * @return pointer to the resized memory-section
+ */
+void*
+RequestArena::grow(void* ptr,
+                   const uint64_t oldSize,
+                   const uint64_t newSize)
+{
+    if(ptr == nullptr) {
+        return allocate(newSize);
+    }
+
+    if(newSize <= oldSize) {
+        return ptr;
+    }
+
+    // resize in-place, if it was the last allocation
+    if(m_activeBlock < m_blocks.size())
+    {
+        ArenaBlock* block = &m_blocks[m_activeBlock];
+        uint8_t* bytePtr = static_cast<uint8_t*>(ptr);
+        if(bytePtr + oldSize == &block->data[m_blockPos]
+                && m_blockPos - oldSize + newSize <= block->size)
+        {
+            m_blockPos += newSize - oldSize;
+            m_usedSize += newSize - oldSize;
+            return ptr;
+        }
+    }
+
+    void* newPtr = allocate(newSize);
+    memcpy(newPtr, ptr, oldSize);
+
+    return newPtr;
+}
+
+/**
+ * @brief release all allocations of the arena at once. The memory-blocks are kept for the next
+ *        request, as long as they are not bigger than the defined limit. Above the limit only
+ *        the first block is kept, if it alone is within the limit.
+ */
+void
+RequestArena::reset()
+{
+    m_activeBlock = 0;
+    m_blockPos = 0;
+    m_usedSize = 0;
+
+    if(m_reservedSize <= MAX_KEPT_ARENA_SIZE) {
+        return;
+    }
+
+    // free all blocks, except the first one, as long as it is not too big itself. The first
+    // block is sized by the first request, so a single big request would pin it forever.
+    const uint64_t numberOfKeptBlocks = m_blocks[0].size <= MAX_KEPT_ARENA_SIZE ? 1 : 0;
+    for(uint64_t i = numberOfKeptBlocks; i < m_blocks.size(); i++) {
+        delete[] m_blocks[i].data;
+    }
+    m_blocks.resize(numberOfKeptBlocks);
+
+    m_reservedSize = 0;
+    if(numberOfKeptBlocks == 1) {
+        m_reservedSize = m_blocks[0].size;
+    }
+}
+
+/**
+ * @brief get number of bytes, which are actually in use
+ *
+ * @return number of used bytes
+ */
+uint64_t
+RequestArena::getUsedSize() const
+{
+    return m_usedSize;
+}
+
+/**
+ * @brief get number of bytes, which are allocated by the arena
+ *
+ * @return number of allocated bytes
+ */
+uint64_t
+RequestArena::getReservedSize() const
+{
+    return m_reservedSize;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,70 @@
+/**
+ * @file        request_arena.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <vector>
+#include <stdint.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class RequestArena
+{
+public:
+    RequestArena(const uint64_t blockSize = 64 * 1024);
+    ~RequestArena();
+
+    void* allocate(const uint64_t size);
+    void* grow(void* ptr,
+               const uint64_t oldSize,
+               const uint64_t newSize);
+    void reset();
+
+    uint64_t getUsedSize() const;
+    uint64_t getReservedSize() const;
+
+private:
+    struct ArenaBlock
+    {
+        uint8_t* data = nullptr;
+        uint64_t size = 0;
+    };
+
+    std::vector<ArenaBlock> m_blocks;
+    uint64_t m_blockSize = 0;
+    uint64_t m_activeBlock = 0;
+    uint64_t m_blockPos = 0;
+    uint64_t m_usedSize = 0;
+    uint64_t m_reservedSize = 0;
+
+    RequestArena(const RequestArena &other) = delete;
+    RequestArena &operator=(const RequestArena &other) = delete;
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // REQUEST_ARENA_H
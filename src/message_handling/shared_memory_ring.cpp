@@ -0,0 +1,475 @@
+/**
+ * @file        shared_memory_ring.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "shared_memory_ring.h"
+
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// maximum number of 10ms-waits of the writer, to not block forever, if the reader has died
+const uint32_t MAX_NUMBER_OF_WRITER_WAITS = 1000;
+
+/**
+ * @brief wait on a futex-word in the shared memory, as long as it has the expected value
+ *
+ * @param word futex-word to wait on
+ * @param expected value, which was read before
+ * @param waitTime maximum time in milliseconds to wait
+ */
+void
+futexWait(std::atomic<uint32_t>* word,
+          const uint32_t expected,
+          const uint32_t waitTime)
+{
+    struct timespec timeout;
+    timeout.tv_sec = waitTime / 1000;
+    timeout.tv_nsec = (waitTime % 1000) * 1000000;
+
+    // no private futex, because the word is shared between processes
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            FUTEX_WAIT,
+            expected,
+            &timeout,
+            nullptr,
+            0);
+}
+
+/**
+ * @brief wake up all processes, which wait on a futex-word in the shared memory
+ *
+ * @param word futex-word to wake up
+ */
+void
+futexWake(std::atomic<uint32_t>* word)
+{
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            FUTEX_WAKE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+}
+
+/**
+ * @brief get size of a record within the ring, which is aligned to 8 byte
+ *
+ * @param dataSize size of the data of the record
+ *
+ * @return size of size-field, data and padding
+ */
+inline uint64_t
+getRecordSize(const uint64_t dataSize)
+{
+    return sizeof(uint64_t) + ((dataSize + 7) / 8) * 8;
+}
+
+/**
+ * @brief constructor
+ */
+SharedMemoryRing::SharedMemoryRing() {}
+
+/**
+ * @brief destructor, which unmaps the shared memory
+ */
+SharedMemoryRing::~SharedMemoryRing()
+{
+    if(m_header != nullptr) {
+        munmap(m_header, m_mappedSize);
+    }
+}
+
+/**
+ * @brief create a new shared memory with a ring-buffer
+ *
+ * @param name name of the new shared memory
+ * @param capacity size of the ring-buffer in bytes
+ * @param error reference for error-output
+ *
+ * @return pointer to the new ring, if successful, else nullptr
+ */
+SharedMemoryRing*
+SharedMemoryRing::createRing(const std::string &name,
+                             const uint64_t capacity,
+                             ErrorContainer &error)
+{
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fd < 0)
+    {
+        error.addMeesage("Failed to create shared memory '" + name + "'");
+        return nullptr;
+    }
+
+    const uint64_t mappedSize = sizeof(SharedMemoryRingHeader) + capacity;
+    // reserve the memory, so a full shm-filesystem results in an error instead of a SIGBUS
+    if(posix_fallocate(fd, 0, static_cast<off_t>(mappedSize)) != 0)
+    {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        error.addMeesage("Failed to allocate shared memory '" + name + "'");
+        return nullptr;
+    }
+
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED)
+    {
+        shm_unlink(name.c_str());
+        error.addMeesage("Failed to map shared memory '" + name + "'");
+        return nullptr;
+    }
+
+    SharedMemoryRing* ring = new SharedMemoryRing();
+    ring->m_header = new(mapped) SharedMemoryRingHeader();
+    ring->m_header->capacity = capacity;
+    ring->m_data = static_cast<uint8_t*>(mapped) + sizeof(SharedMemoryRingHeader);
+    ring->m_mappedSize = mappedSize;
+
+    return ring;
+}
+
+/**
+ * @brief open an existing shared memory with a ring-buffer. The name is removed afterwards,
+ *        so the memory is freed, when both sides have unmapped it.
+ *
+ * @param name name of the shared memory
+ * @param error reference for error-output
+ *
+ * @return pointer to the ring, if successful, else nullptr
+ */
+SharedMemoryRing*
+SharedMemoryRing::openRing(const std::string &name,
+                           ErrorContainer &error)
+{
+    const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if(fd < 0)
+    {
+        error.addMeesage("Failed to open shared memory '" + name + "'");
+        return nullptr;
+    }
+    shm_unlink(name.c_str());
+
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0
+            || static_cast<uint64_t>(fileStat.st_size) <= sizeof(SharedMemoryRingHeader))
+    {
+        ::close(fd);
+        error.addMeesage("Shared memory '" + name + "' has an invalid size");
+        return nullptr;
+    }
+
+    const uint64_t mappedSize = static_cast<uint64_t>(fileStat.st_size);
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED)
+    {
+        error.addMeesage("Failed to map shared memory '" + name + "'");
+        return nullptr;
+    }
+
+    SharedMemoryRing* ring = new SharedMemoryRing();
+    ring->m_header = static_cast<SharedMemoryRingHeader*>(mapped);
+    ring->m_data = static_cast<uint8_t*>(mapped) + sizeof(SharedMemoryRingHeader);
+    ring->m_mappedSize = mappedSize;
+
+    // don't trust the header of the other process more than the real size of the memory
+    if(ring->m_header->capacity != mappedSize - sizeof(SharedMemoryRingHeader))
+    {
+        delete ring;
+        error.addMeesage("Shared memory '" + name + "' has an invalid header");
+        return nullptr;
+    }
+
+    return ring;
+}
+
+/**
+ * @brief get maximum size of data, which can be written as one record. Bigger records would
+ *        block the ring for too long, so they are limited to a half of the ring.
+ *
+ * @return maximum size in bytes
+ */
+uint64_t
+SharedMemoryRing::getMaxRecordSize() const
+{
+    return m_header->capacity / 2 - sizeof(uint64_t);
+}
+
+/**
+ * @brief copy data into the ring and wrap at the end of the ring
+ *
+ * @param pos absolute position within the ring
+ * @param data data to copy
+ * @param dataSize size of the data
+ */
+void
+SharedMemoryRing::copyIntoRing(const uint64_t pos, const void* data, const uint64_t dataSize)
+{
+    const uint64_t capacity = m_header->capacity;
+    const uint64_t start = pos % capacity;
+    const uint64_t firstPart = std::min(dataSize, capacity - start);
+
+    memcpy(&m_data[start], data, firstPart);
+    if(firstPart < dataSize) {
+        memcpy(&m_data[0], static_cast<const uint8_t*>(data) + firstPart, dataSize - firstPart);
+    }
+}
+
+/**
+ * @brief copy data out of the ring and wrap at the end of the ring
+ *
+ * @param pos absolute position within the ring
+ * @param data target-buffer
+ * @param dataSize size of the data
+ */
+void
+SharedMemoryRing::copyFromRing(const uint64_t pos, void* data, const uint64_t dataSize)
+{
+    const uint64_t capacity = m_header->capacity;
+    const uint64_t start = pos % capacity;
+    const uint64_t firstPart = std::min(dataSize, capacity - start);
+
+    memcpy(data, &m_data[start], firstPart);
+    if(firstPart < dataSize) {
+        memcpy(static_cast<uint8_t*>(data) + firstPart, &m_data[0], dataSize - firstPart);
+    }
+}
+
+/**
+ * @brief write a new record into the ring and wake up the reader
+ *
+ * @param data data to write
+ * @param dataSize size of the data, which must not be bigger than the max record-size
+ * @param wait true to wait until enough space is free
+ *
+ * @return false, if not enough space is free without waiting or after the maximum wait-time,
+ *         if the data are too big or if the ring was closed, else true
+ */
+bool
+SharedMemoryRing::writeRecord(const void* data,
+                              const uint64_t dataSize,
+                              const bool wait)
+{
+    // nobody reads the records of a closed ring anymore and too big records would be handled
+    // as broken by the reader
+    if(m_header->closed.load()
+            || dataSize > getMaxRecordSize())
+    {
+        return false;
+    }
+
+    const uint64_t recordSize = getRecordSize(dataSize);
+    const uint64_t capacity = m_header->capacity;
+    const uint64_t writePos = m_header->writePos.load(std::memory_order_relaxed);
+
+    // wait for enough free space
+    uint32_t numberOfWaits = 0;
+    while(capacity - (writePos - m_header->readPos.load()) < recordSize)
+    {
+        if(wait == false
+                || m_header->closed.load()
+                || numberOfWaits == MAX_NUMBER_OF_WRITER_WAITS)
+        {
+            return false;
+        }
+        numberOfWaits++;
+
+        const uint32_t signal = m_header->spaceSignal.load();
+        m_header->writerWaiting.store(1);
+        if(capacity - (writePos - m_header->readPos.load()) < recordSize) {
+            futexWait(&m_header->spaceSignal, signal, 10);
+        }
+        m_header->writerWaiting.store(0);
+    }
+
+    copyIntoRing(writePos, &dataSize, sizeof(uint64_t));
+    copyIntoRing(writePos + sizeof(uint64_t), data, dataSize);
+
+    // publish record and wake up the reader, if it is sleeping
+    m_header->writePos.store(writePos + recordSize);
+    m_header->dataSignal.fetch_add(1);
+    if(m_header->readerWaiting.load()) {
+        futexWake(&m_header->dataSignal);
+    }
+
+    return true;
+}
+
+/**
+ * @brief wait until the reader has processed all records
+ *
+ * @return false, if the ring was closed or the maximum wait-time was reached, else true
+ */
+bool
+SharedMemoryRing::waitUntilEmpty()
+{
+    const uint64_t writePos = m_header->writePos.load(std::memory_order_relaxed);
+
+    uint32_t numberOfWaits = 0;
+    while(m_header->readPos.load() != writePos)
+    {
+        if(m_header->closed.load()
+                || numberOfWaits == MAX_NUMBER_OF_WRITER_WAITS)
+        {
+            return false;
+        }
+        numberOfWaits++;
+
+        const uint32_t signal = m_header->spaceSignal.load();
+        m_header->writerWaiting.store(1);
+        if(m_header->readPos.load() != writePos) {
+            futexWait(&m_header->spaceSignal, signal, 10);
+        }
+        m_header->writerWaiting.store(0);
+    }
+
+    return true;
+}
+
+/**
+ * @brief check if the reader has processed all records
+ *
+ * @return true, if no record is left in the ring, else false
+ */
+bool
+SharedMemoryRing::isEmpty() const
+{
+    return m_header->readPos.load() == m_header->writePos.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief get the next record of the ring. The record stays in the ring until releaseRecord is
+ *        called, so the data can be used without copy, if it isn't wrapped at the end of the ring.
+ *
+ * @param waitTime maximum time in milliseconds to wait for a new record
+ * @param data reference for the pointer to the data of the record
+ * @param dataSize reference for the size of the data of the record
+ *
+ * @return false, if no record is available after the wait-time, else true
+ */
+bool
+SharedMemoryRing::readRecord(const uint32_t waitTime,
+                             const void* &data,
+                             uint64_t &dataSize)
+{
+    const uint64_t readPos = m_header->readPos.load(std::memory_order_relaxed);
+
+    // wait for new record
+    if(m_header->writePos.load() == readPos)
+    {
+        const uint32_t signal = m_header->dataSignal.load();
+        m_header->readerWaiting.store(1);
+        if(m_header->writePos.load() == readPos) {
+            futexWait(&m_header->dataSignal, signal, waitTime);
+        }
+        m_header->readerWaiting.store(0);
+
+        if(m_header->writePos.load() == readPos) {
+            return false;
+        }
+    }
+
+    // check size, because the memory is shared with another process
+    copyFromRing(readPos, &dataSize, sizeof(uint64_t));
+    const uint64_t available = m_header->writePos.load() - readPos;
+    if(dataSize > getMaxRecordSize()
+            || getRecordSize(dataSize) > available)
+    {
+        LOG_WARNING("shared memory contains a broken record");
+        close();
+        return false;
+    }
+
+    // use data directly, if it's not wrapped
+    const uint64_t capacity = m_header->capacity;
+    const uint64_t dataStart = (readPos + sizeof(uint64_t)) % capacity;
+    if(dataStart + dataSize <= capacity)
+    {
+        data = &m_data[dataStart];
+    }
+    else
+    {
+        m_readBuffer.resize(dataSize);
+        copyFromRing(readPos + sizeof(uint64_t), &m_readBuffer[0], dataSize);
+        data = &m_readBuffer[0];
+    }
+
+    m_readRecordSize = getRecordSize(dataSize);
+
+    return true;
+}
+
+/**
+ * @brief release the last read record and wake up the writer
+ */
+void
+SharedMemoryRing::releaseRecord()
+{
+    const uint64_t readPos = m_header->readPos.load(std::memory_order_relaxed);
+    m_header->readPos.store(readPos + m_readRecordSize);
+    m_readRecordSize = 0;
+
+    m_header->spaceSignal.fetch_add(1);
+    if(m_header->writerWaiting.load()) {
+        futexWake(&m_header->spaceSignal);
+    }
+}
+
+/**
+ * @brief mark the ring as closed and wake up both sides
+ */
+void
+SharedMemoryRing::close()
+{
+    m_header->closed.store(1);
+
+    m_header->dataSignal.fetch_add(1);
+    futexWake(&m_header->dataSignal);
+    m_header->spaceSignal.fetch_add(1);
+    futexWake(&m_header->spaceSignal);
+}
+
+/**
+ * @brief check if one of the sides has closed the ring
+ *
+ * @return true, if closed, else false
+ */
+bool
+SharedMemoryRing::isClosed() const
+{
+    return m_header->closed.load() != 0;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,99 @@
+/**
+ * @file        shared_memory_ring.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef SHARED_MEMORY_RING_H
+#define SHARED_MEMORY_RING_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <new>
+
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief header at the begin of the shared memory. All positions are absolute byte-positions,
+ *        which are only increased, so the position within the ring is position % capacity.
+ */
+struct SharedMemoryRingHeader
+{
+    std::atomic<uint64_t> writePos{0};
+    std::atomic<uint64_t> readPos{0};
+    // futex-words, which are increased for each new record and each released record
+    std::atomic<uint32_t> dataSignal{0};
+    std::atomic<uint32_t> spaceSignal{0};
+    std::atomic<uint32_t> readerWaiting{0};
+    std::atomic<uint32_t> writerWaiting{0};
+    std::atomic<uint32_t> closed{0};
+    uint64_t capacity = 0;
+};
+
+class SharedMemoryRing
+{
+public:
+    static SharedMemoryRing* createRing(const std::string &name,
+                                        const uint64_t capacity,
+                                        ErrorContainer &error);
+    static SharedMemoryRing* openRing(const std::string &name,
+                                      ErrorContainer &error);
+    ~SharedMemoryRing();
+
+    uint64_t getMaxRecordSize() const;
+
+    bool writeRecord(const void* data,
+                     const uint64_t dataSize,
+                     const bool wait);
+    bool waitUntilEmpty();
+    bool isEmpty() const;
+
+    bool readRecord(const uint32_t waitTime,
+                    const void* &data,
+                    uint64_t &dataSize);
+    void releaseRecord();
+
+    void close();
+    bool isClosed() const;
+
+private:
+    SharedMemoryRing();
+
+    SharedMemoryRingHeader* m_header = nullptr;
+    uint8_t* m_data = nullptr;
+    uint64_t m_mappedSize = 0;
+
+    // buffer for records, which are wrapped at the end of the ring
+    std::vector<uint8_t> m_readBuffer;
+    uint64_t m_readRecordSize = 0;
+
+    void copyIntoRing(const uint64_t pos, const void* data, const uint64_t dataSize);
+    void copyFromRing(const uint64_t pos, void* data, const uint64_t dataSize);
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // SHARED_MEMORY_RING_H
@@ -0,0 +1,261 @@
+/**
+ * @file        shared_memory_transport.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "shared_memory_transport.h"
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <message_handling/message_definitions.h>
+#include <message_handling/shared_memory_ring.h>
+#include <message_handling/stream_offload_queue.h>
+
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// size of the ring-buffer of new shared memories in bytes. 0 disables the shared memory and all
+// stream-messages are send over the socket.
+std::atomic<uint64_t> g_sharedMemoryRingSize{4 * 1024 * 1024};
+
+// only shared memories with this prefix are opened and unlinked by the receiver
+const std::string SHARED_MEMORY_PREFIX = "/hanami-shm-";
+
+std::atomic<uint64_t> g_sharedMemoryCounter{0};
+
+std::map<Sakura::Session*, SharedMemoryReader*> g_sharedMemoryReaders;
+std::mutex g_sharedMemoryReadersLock;
+
+/**
+ * @brief constructor
+ *
+ * @param session session, which receives the stream-messages of the shared memory
+ * @param ring ring-buffer, which is taken over by the reader
+ */
+SharedMemoryReader::SharedMemoryReader(Sakura::Session* session,
+                                       SharedMemoryRing* ring)
+    : Kitsunemimi::Thread("SharedMemoryReader")
+{
+    m_session = session;
+    m_ring = ring;
+}
+
+/**
+ * @brief destructor
+ */
+SharedMemoryReader::~SharedMemoryReader()
+{
+    m_ring->close();
+    stopThread();
+    delete m_ring;
+}
+
+/**
+ * @brief forward all records of the ring-buffer like stream-messages, which were received by
+ *        the session
+ */
+void
+SharedMemoryReader::run()
+{
+    while(m_abort == false)
+    {
+        const void* data = nullptr;
+        uint64_t dataSize = 0;
+        if(m_ring->readRecord(10, data, dataSize))
+        {
+            deliverStreamMessage(m_session, data, dataSize);
+            m_ring->releaseRecord();
+        }
+        else if(m_ring->isClosed())
+        {
+            // the sender is gone, so wait until the session is closed
+            sleepThread(10000);
+        }
+    }
+}
+
+/**
+ * @brief set size of the ring-buffer for new shared memories
+ *
+ * @param ringSize size in bytes, where 0 disables the shared memory
+ */
+void
+setSharedMemoryRingSize(const uint64_t ringSize)
+{
+    g_sharedMemoryRingSize = ringSize;
+}
+
+/**
+ * @brief create a new shared memory and offer it to the receiver of a session. The offer is a
+ *        request, so no stream-message can be send over the socket, until the receiver has
+ *        accepted the shared memory. This way the order of all stream-messages is kept.
+ *
+ * @param session session to a receiver on the same host
+ * @param error reference for error-output
+ *
+ * @return pointer to the ring-buffer, if accepted by the receiver, else nullptr
+ */
+SharedMemoryRing*
+offerSharedMemoryRing(Sakura::Session* session,
+                      ErrorContainer &error)
+{
+    const uint64_t ringSize = g_sharedMemoryRingSize;
+    if(ringSize == 0) {
+        return nullptr;
+    }
+
+    const std::string name = SHARED_MEMORY_PREFIX
+                             + std::to_string(getpid())
+                             + "-"
+                             + std::to_string(g_sharedMemoryCounter.fetch_add(1));
+    SharedMemoryRing* ring = SharedMemoryRing::createRing(name, ringSize, error);
+    if(ring == nullptr) {
+        return nullptr;
+    }
+
+    SharedMemoryHeader header;
+    memset(header.name, 0, sizeof(header.name));
+    strncpy(header.name, name.c_str(), sizeof(header.name) - 1);
+
+    // receiver without support for shared memory doesn't answer, so the timeout is short
+    DataBuffer* response = session->sendRequest(&header, sizeof(SharedMemoryHeader), 1, error);
+    bool accepted = false;
+    if(response != nullptr)
+    {
+        const SharedMemoryHeader* responseHeader =
+                static_cast<const SharedMemoryHeader*>(response->data);
+        accepted = response->usedBufferSize >= sizeof(SharedMemoryHeader)
+                   && responseHeader->type == SAKURA_SHARED_MEMORY_MESSAGE
+                   && responseHeader->accept;
+        delete response;
+    }
+
+    if(accepted == false)
+    {
+        // the receiver normally unlinks the shared memory, after it has opened it
+        shm_unlink(name.c_str());
+        delete ring;
+        error.addMeesage("Receiver has not accepted shared memory '" + name + "'");
+        return nullptr;
+    }
+
+    return ring;
+}
+
+/**
+ * @brief process the offer of a shared memory, start a thread to read the ring-buffer and
+ *        answer the offer
+ *
+ * @param session session, where the offer was received
+ * @param data pointer to the offer
+ * @param dataSize size of the offer
+ * @param blockerId blocker-id for the response
+ */
+void
+acceptSharedMemoryRing(Sakura::Session* session,
+                       const void* data,
+                       const uint64_t dataSize,
+                       const uint64_t blockerId)
+{
+    ErrorContainer error;
+    SharedMemoryHeader response;
+    memset(response.name, 0, sizeof(response.name));
+
+    SharedMemoryRing* ring = nullptr;
+    if(dataSize >= sizeof(SharedMemoryHeader))
+    {
+        const SharedMemoryHeader* header = static_cast<const SharedMemoryHeader*>(data);
+        const std::string name(header->name, strnlen(header->name, sizeof(header->name)));
+        if(name.compare(0, SHARED_MEMORY_PREFIX.size(), SHARED_MEMORY_PREFIX) == 0) {
+            ring = SharedMemoryRing::openRing(name, error);
+        } else {
+            error.addMeesage("Offered shared memory '" + name + "' has an invalid name");
+        }
+    }
+    else
+    {
+        error.addMeesage("Received broken offer of shared memory");
+    }
+
+    if(ring != nullptr)
+    {
+        SharedMemoryReader* reader = new SharedMemoryReader(session, ring);
+        SharedMemoryReader* oldReader = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(g_sharedMemoryReadersLock);
+
+            std::map<Sakura::Session*, SharedMemoryReader*>::iterator it;
+            it = g_sharedMemoryReaders.find(session);
+            if(it != g_sharedMemoryReaders.end()) {
+                oldReader = it->second;
+            }
+            g_sharedMemoryReaders[session] = reader;
+        }
+
+        if(oldReader != nullptr) {
+            delete oldReader;
+        }
+        reader->startThread();
+        response.accept = true;
+    }
+    else
+    {
+        LOG_ERROR(error);
+    }
+
+    session->sendResponse(&response, sizeof(SharedMemoryHeader), blockerId, error);
+}
+
+/**
+ * @brief stop and delete the reader of a session, if exist
+ *
+ * @param session session of the reader
+ */
+void
+removeSharedMemoryReader(Sakura::Session* session)
+{
+    SharedMemoryReader* reader = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(g_sharedMemoryReadersLock);
+
+        std::map<Sakura::Session*, SharedMemoryReader*>::iterator it;
+        it = g_sharedMemoryReaders.find(session);
+        if(it == g_sharedMemoryReaders.end()) {
+            return;
+        }
+
+        reader = it->second;
+        g_sharedMemoryReaders.erase(it);
+    }
+
+    delete reader;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,68 @@
+/**
+ * @file        shared_memory_transport.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef SHARED_MEMORY_TRANSPORT_H
+#define SHARED_MEMORY_TRANSPORT_H
+
+#include <string>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+#include <libKitsunemimiCommon/logger.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura {
+class Session;
+}
+namespace Hanami
+{
+class SharedMemoryRing;
+
+class SharedMemoryReader
+        : public Kitsunemimi::Thread
+{
+public:
+    SharedMemoryReader(Sakura::Session* session,
+                       SharedMemoryRing* ring);
+    ~SharedMemoryReader();
+
+protected:
+    void run();
+
+private:
+    Sakura::Session* m_session = nullptr;
+    SharedMemoryRing* m_ring = nullptr;
+};
+
+void setSharedMemoryRingSize(const uint64_t ringSize);
+SharedMemoryRing* offerSharedMemoryRing(Sakura::Session* session,
+                                        ErrorContainer &error);
+void acceptSharedMemoryRing(Sakura::Session* session,
+                            const void* data,
+                            const uint64_t dataSize,
+                            const uint64_t blockerId);
+void removeSharedMemoryReader(Sakura::Session* session);
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // SHARED_MEMORY_TRANSPORT_H
@@ -0,0 +1,298 @@
+/**
+ * @file        stream_coalescer.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "stream_coalescer.h"
+
+#include <string.h>
+
+#include <message_handling/message_definitions.h>
+
+#include <libKitsunemimiCommon/buffer/stack_buffer.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ *
+ * @param client client, which sends the coalesced stream-messages
+ * @param maxFrameSize size in bytes, at which the collected records are send
+ * @param maxDelay maximum time in microseconds, which a record is hold back
+ */
+StreamCoalescer::StreamCoalescer(HanamiMessagingClient* client,
+                                 const uint64_t maxFrameSize,
+                                 const uint32_t maxDelay)
+    : Kitsunemimi::Thread("StreamCoalescer")
+{
+    m_client = client;
+    m_maxFrameSize = maxFrameSize;
+    m_maxDelay = std::chrono::microseconds(maxDelay);
+    m_frame.reserve(maxFrameSize + sizeof(StreamRecordHeader));
+}
+
+/**
+ * @brief add a stream-message as record to the current frame. The frame is send, if it reaches
+ *        the maximum size, if a reply is expected or by the thread, when the deadline of the
+ *        first record of the frame is reached.
+ *
+ * @param data pointer to the data to send
+ * @param dataSize size of data in bytes to send
+ * @param replyExpected true to expect a reply-message
+ * @param wait true to wait for credits of the flow-control
+ * @param error reference for error-output
+ *
+ * @return STREAM_SEND_WOULD_BLOCK, if the record could not be added without waiting,
+ *         STREAM_SEND_FAILED, if sending failed, else STREAM_SEND_OK
+ */
+StreamSendResult
+StreamCoalescer::addRecord(const void* data,
+                           const uint64_t dataSize,
+                           const bool replyExpected,
+                           const bool wait,
+                           ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_frameLock);
+    return appendRecord(data, dataSize, replyExpected, wait, error);
+}
+
+/**
+ * @brief add all blocks of a stack-buffer as records, so they are packed into as few frames as
+ *        possible. Each block is given back to the reserve of the stack-buffer after it was
+ *        copied into the frame.
+ *
+ * @param data stack-buffer with the blocks to send
+ * @param error reference for error-output
+ *
+ * @return STREAM_SEND_FAILED, if sending failed, else STREAM_SEND_OK
+ */
+StreamSendResult
+StreamCoalescer::addRecords(StackBuffer &data,
+                            ErrorContainer &error)
+{
+    std::lock_guard<std::mutex> guard(m_frameLock);
+
+    while(data.blocks.size() > 0)
+    {
+        DataBuffer* buf = getFirstElement_StackBuffer(data);
+
+        // only the last block should have an expected reply
+        const bool expReply = data.blocks.size() == 1;
+        const StreamSendResult ret = appendRecord(buf->data,
+                                                  buf->usedBufferSize,
+                                                  expReply,
+                                                  true,
+                                                  error);
+        if(ret != STREAM_SEND_OK) {
+            return ret;
+        }
+
+        removeFirst_StackBuffer(data);
+    }
+
+    return STREAM_SEND_OK;
+}
+
+/**
+ * @brief add a record to the current frame, while the frame-lock is hold
+ *
+ * @param data pointer to the data to send
+ * @param dataSize size of data in bytes to send
+ * @param replyExpected true to expect a reply-message
+ * @param wait true to wait for credits of the flow-control
+ * @param error reference for error-output
+ *
+ * @return STREAM_SEND_WOULD_BLOCK, if the record could not be added without waiting,
+ *         STREAM_SEND_FAILED, if sending failed, else STREAM_SEND_OK
+ */
+StreamSendResult
+StreamCoalescer::appendRecord(const void* data,
+                              const uint64_t dataSize,
+                              const bool replyExpected,
+                              const bool wait,
+                              ErrorContainer &error)
+{
+    if(dataSize > UINT32_MAX)
+    {
+        error.addMeesage("Stream-message is too big for coalescing");
+        return STREAM_SEND_FAILED;
+    }
+
+    // send the already collected records first, if the new one doesn't fit into the frame or
+    // if the frame is already completed by a record, which expects a reply
+    const uint64_t recordSize = sizeof(StreamRecordHeader) + dataSize;
+    if(m_frame.size() > 0
+            && (m_replyExpected
+                || m_frame.size() + recordSize > m_maxFrameSize))
+    {
+        const StreamSendResult ret = sendFrame(wait, error);
+        if(ret != STREAM_SEND_OK) {
+            return ret;
+        }
+    }
+
+    // the first record of a frame defines the latest time, when the frame has to be send
+    const bool firstRecord = m_frame.size() == 0;
+    if(firstRecord) {
+        m_deadline = std::chrono::steady_clock::now() + m_maxDelay;
+    }
+
+    StreamRecordHeader header;
+    header.size = static_cast<uint32_t>(dataSize);
+    const uint64_t pos = m_frame.size();
+    m_frame.resize(pos + recordSize);
+    memcpy(&m_frame[pos], &header, sizeof(StreamRecordHeader));
+    memcpy(&m_frame[pos + sizeof(StreamRecordHeader)], data, dataSize);
+    m_numberOfRecords++;
+    m_replyExpected = replyExpected;
+
+    if(replyExpected
+            || m_frame.size() >= m_maxFrameSize)
+    {
+        // if no credits are available, the record is already accepted and the frame is send by
+        // the thread of the coalescer together with the reply-flag, so the caller is not blocked
+        const StreamSendResult ret = sendFrame(wait, error);
+        if(ret == STREAM_SEND_WOULD_BLOCK) {
+            return STREAM_SEND_OK;
+        }
+        return ret;
+    }
+
+    if(firstRecord) {
+        m_frameCondition.notify_one();
+    }
+
+    return STREAM_SEND_OK;
+}
+
+/**
+ * @brief send all collected records as one stream-message. The frame expects a reply, if its
+ *        last record expects one.
+ *
+ * @param wait true to wait for credits of the flow-control
+ * @param error reference for error-output
+ *
+ * @return result of the send-process
+ */
+StreamSendResult
+StreamCoalescer::sendFrame(const bool wait,
+                           ErrorContainer &error)
+{
+    const StreamSendResult ret = m_client->sendStreamData(&m_frame[0],
+                                                          m_frame.size(),
+                                                          m_replyExpected,
+                                                          wait,
+                                                          error);
+    if(ret == STREAM_SEND_WOULD_BLOCK) {
+        return ret;
+    }
+
+    // if sending failed, the records are dropped, because the session is broken anyway, but the
+    // callers of the records were already informed about a successful send
+    if(ret == STREAM_SEND_FAILED)
+    {
+        error.addMeesage("Dropped "
+                         + std::to_string(m_numberOfRecords)
+                         + " coalesced stream-records, which were already accepted");
+    }
+
+    m_frame.clear();
+    m_numberOfRecords = 0;
+    m_replyExpected = false;
+
+    return ret;
+}
+
+/**
+ * @brief send the remaining records and stop the thread of the coalescer
+ */
+void
+StreamCoalescer::close()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_frameLock);
+        m_closed = true;
+        if(m_frame.size() > 0)
+        {
+            ErrorContainer error;
+            const StreamSendResult ret = sendFrame(false, error);
+            if(ret == STREAM_SEND_FAILED)
+            {
+                LOG_ERROR(error);
+            }
+            else if(ret == STREAM_SEND_WOULD_BLOCK)
+            {
+                LOG_WARNING("Dropped "
+                            + std::to_string(m_numberOfRecords)
+                            + " coalesced stream-records while closing, because no credits of "
+                              "the flow-control were available");
+                m_frame.clear();
+                m_numberOfRecords = 0;
+                m_replyExpected = false;
+            }
+        }
+    }
+
+    m_frameCondition.notify_one();
+    stopThread();
+}
+
+/**
+ * @brief send the collected records, when the deadline of the frame is reached
+ */
+void
+StreamCoalescer::run()
+{
+    std::unique_lock<std::mutex> lock(m_frameLock);
+
+    while(m_abort == false
+          && m_closed == false)
+    {
+        // wait for the first record
+        if(m_frame.size() == 0)
+        {
+            m_frameCondition.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(now < m_deadline)
+        {
+            m_frameCondition.wait_until(lock, m_deadline);
+            continue;
+        }
+
+        // don't block the lock while waiting for credits, so producers are not blocked, and try
+        // again shortly
+        ErrorContainer error;
+        const StreamSendResult ret = sendFrame(false, error);
+        if(ret == STREAM_SEND_FAILED) {
+            LOG_ERROR(error);
+        } else if(ret == STREAM_SEND_WOULD_BLOCK) {
+            m_frameCondition.wait_for(lock, std::chrono::microseconds(100));
+        }
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,84 @@
+/**
+ * @file        stream_coalescer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef STREAM_COALESCER_H
+#define STREAM_COALESCER_H
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class StreamCoalescer
+        : public Kitsunemimi::Thread
+{
+public:
+    StreamCoalescer(HanamiMessagingClient* client,
+                    const uint64_t maxFrameSize,
+                    const uint32_t maxDelay);
+
+    StreamSendResult addRecord(const void* data,
+                               const uint64_t dataSize,
+                               const bool replyExpected,
+                               const bool wait,
+                               ErrorContainer &error);
+    StreamSendResult addRecords(StackBuffer &data,
+                                ErrorContainer &error);
+    void close();
+
+protected:
+    void run();
+
+private:
+    HanamiMessagingClient* m_client = nullptr;
+    uint64_t m_maxFrameSize = 0;
+    std::chrono::microseconds m_maxDelay;
+
+    std::vector<uint8_t> m_frame;
+    uint64_t m_numberOfRecords = 0;
+    bool m_replyExpected = false;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::mutex m_frameLock;
+    std::condition_variable m_frameCondition;
+    bool m_closed = false;
+
+    StreamSendResult appendRecord(const void* data,
+                                  const uint64_t dataSize,
+                                  const bool replyExpected,
+                                  const bool wait,
+                                  ErrorContainer &error);
+    StreamSendResult sendFrame(const bool wait,
+                               ErrorContainer &error);
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // STREAM_COALESCER_H
@@ -0,0 +1,162 @@
+/**
+ * @file        stream_flow_control.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "stream_flow_control.h"
+
+#include <map>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// credits of the outgoing sessions with enabled flow-control, to find them, when the receiver
+// grants new credits
+std::map<Sakura::Session*, StreamCredits*> g_streamCredits;
+std::mutex g_streamCreditsLock;
+
+/**
+ * @brief take credits for a new stream-message. A message can be send, as long as any credit is
+ *        available, so also messages, which are bigger than the window, can be send.
+ *
+ * @param credits credits of the sender
+ * @param dataSize size of the message to send
+ * @param wait true to wait until credits are available
+ *
+ * @return false, if no credits are available or the sender was closed, else true
+ */
+bool
+takeStreamCredits(StreamCredits* credits,
+                  const uint64_t dataSize,
+                  const bool wait)
+{
+    std::unique_lock<std::mutex> lock(credits->lock);
+
+    if(wait)
+    {
+        while(credits->availableCredits <= 0
+              && credits->closed == false)
+        {
+            credits->creditCondition.wait(lock);
+        }
+    }
+
+    if(credits->availableCredits <= 0
+            || credits->closed)
+    {
+        return false;
+    }
+
+    credits->availableCredits -= static_cast<int64_t>(dataSize);
+
+    return true;
+}
+
+/**
+ * @brief give credits back, if the stream-message could not be send
+ *
+ * @param credits credits of the sender
+ * @param dataSize size of the message, which could not be send
+ */
+void
+returnStreamCredits(StreamCredits* credits,
+                    const uint64_t dataSize)
+{
+    {
+        std::lock_guard<std::mutex> guard(credits->lock);
+        credits->availableCredits += static_cast<int64_t>(dataSize);
+    }
+
+    credits->creditCondition.notify_all();
+}
+
+/**
+ * @brief reset credits to the full window, for example for a new session, and wake up all
+ *        waiting senders
+ *
+ * @param credits credits of the sender
+ * @param closed true to release all waiting senders without credits
+ */
+void
+resetStreamCredits(StreamCredits* credits,
+                   const bool closed)
+{
+    {
+        std::lock_guard<std::mutex> guard(credits->lock);
+        credits->availableCredits = static_cast<int64_t>(credits->windowSize);
+        credits->closed = closed;
+    }
+
+    credits->creditCondition.notify_all();
+}
+
+/**
+ * @brief register credits for a session, so granted credits of the receiver can be added
+ *
+ * @param session session of the sender
+ * @param credits credits of the sender
+ */
+void
+registerStreamCredits(Sakura::Session* session, StreamCredits* credits)
+{
+    std::lock_guard<std::mutex> guard(g_streamCreditsLock);
+    g_streamCredits[session] = credits;
+}
+
+/**
+ * @brief remove the credits of a session from the registry
+ *
+ * @param session session of the sender
+ */
+void
+unregisterStreamCredits(Sakura::Session* session)
+{
+    std::lock_guard<std::mutex> guard(g_streamCreditsLock);
+    g_streamCredits.erase(session);
+}
+
+/**
+ * @brief add credits, which were granted by the receiver, and wake up waiting senders
+ *
+ * @param session session, where the grant was received
+ * @param credits number of granted credits in bytes
+ *
+ * @return false, if the session has no flow-control, else true
+ */
+bool
+addStreamCredits(Sakura::Session* session, const uint64_t credits)
+{
+    std::lock_guard<std::mutex> guard(g_streamCreditsLock);
+
+    std::map<Sakura::Session*, StreamCredits*>::const_iterator it;
+    it = g_streamCredits.find(session);
+    if(it == g_streamCredits.end()) {
+        return false;
+    }
+
+    returnStreamCredits(it->second, credits);
+
+    return true;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,65 @@
+/**
+ * @file        stream_flow_control.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef STREAM_FLOW_CONTROL_H
+#define STREAM_FLOW_CONTROL_H
+
+#include <mutex>
+#include <condition_variable>
+
+namespace Kitsunemimi
+{
+namespace Sakura {
+class Session;
+}
+namespace Hanami
+{
+
+/**
+ * @brief credits of a sender with enabled flow-control. Each stream-message consumes its size
+ *        in credits and the receiver grants the consumed bytes back.
+ */
+struct StreamCredits
+{
+    std::mutex lock;
+    std::condition_variable creditCondition;
+    uint64_t windowSize = 0;
+    int64_t availableCredits = 0;
+    bool closed = false;
+};
+
+bool takeStreamCredits(StreamCredits* credits,
+                       const uint64_t dataSize,
+                       const bool wait);
+void returnStreamCredits(StreamCredits* credits,
+                         const uint64_t dataSize);
+void resetStreamCredits(StreamCredits* credits,
+                        const bool closed);
+
+void registerStreamCredits(Sakura::Session* session, StreamCredits* credits);
+void unregisterStreamCredits(Sakura::Session* session);
+bool addStreamCredits(Sakura::Session* session, const uint64_t credits);
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // STREAM_FLOW_CONTROL_H
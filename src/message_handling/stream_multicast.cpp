@@ -0,0 +1,107 @@
+/**
+ * @file        stream_multicast.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "stream_multicast.h"
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ *
+ * @param job job, which should be processed by the event
+ */
+StreamMulticastEvent::StreamMulticastEvent(const std::shared_ptr<StreamMulticastJob> &job)
+{
+    m_job = job;
+}
+
+/**
+ * @brief help to send the stream-message of the job to its targets
+ *
+ * @return true
+ */
+bool
+StreamMulticastEvent::processEvent()
+{
+    processStreamMulticastJob(m_job.get());
+    return true;
+}
+
+/**
+ * @brief send the stream-message of the job to the unprocessed targets, until all targets are
+ *        taken by this or another thread
+ *
+ * @param job job to process
+ */
+void
+processStreamMulticastJob(StreamMulticastJob* job)
+{
+    const uint64_t numberOfTargets = job->clients.size();
+
+    while(true)
+    {
+        const uint64_t target = job->nextTarget.fetch_add(1);
+        if(target >= numberOfTargets) {
+            return;
+        }
+
+        // each target has its own entry for the error-message, so no lock is necessary
+        ErrorContainer error;
+        HanamiMessagingClient* client = job->clients[target];
+        if(client->sendStreamMessage(job->data->data,
+                                     job->data->usedBufferSize,
+                                     false,
+                                     error) == false)
+        {
+            job->errorMessages[target] = error.toString();
+        }
+
+        // wake up the caller after the last target
+        if(job->finishedTargets.fetch_add(1) + 1 == numberOfTargets)
+        {
+            std::lock_guard<std::mutex> guard(job->finishedLock);
+            job->finishedCondition.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief wait until the stream-message was send to all targets of the job
+ *
+ * @param job job to wait for
+ */
+void
+waitForStreamMulticastJob(StreamMulticastJob* job)
+{
+    std::unique_lock<std::mutex> lock(job->finishedLock);
+    while(job->finishedTargets.load() < job->clients.size()) {
+        job->finishedCondition.wait(lock);
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
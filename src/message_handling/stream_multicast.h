@@ -0,0 +1,77 @@
+/**
+ * @file        stream_multicast.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef STREAM_MULTICAST_H
+#define STREAM_MULTICAST_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/event.h>
+#include <libKitsunemimiCommon/buffer/data_buffer.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+class HanamiMessagingClient;
+
+/**
+ * @brief stream-message, which is send to multiple clients. The targets are processed by the
+ *        calling thread and by worker-threads at the same time, where each takes the next
+ *        unprocessed target.
+ */
+struct StreamMulticastJob
+{
+    std::shared_ptr<DataBuffer> data;
+    std::vector<HanamiMessagingClient*> clients;
+    std::vector<std::string> errorMessages;
+
+    std::atomic<uint64_t> nextTarget{0};
+    std::atomic<uint64_t> finishedTargets{0};
+    std::mutex finishedLock;
+    std::condition_variable finishedCondition;
+};
+
+class StreamMulticastEvent
+        : public Event
+{
+public:
+    StreamMulticastEvent(const std::shared_ptr<StreamMulticastJob> &job);
+
+    bool processEvent();
+
+private:
+    std::shared_ptr<StreamMulticastJob> m_job;
+};
+
+void processStreamMulticastJob(StreamMulticastJob* job);
+void waitForStreamMulticastJob(StreamMulticastJob* job);
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // STREAM_MULTICAST_H
@@ -0,0 +1,700 @@
+/**
+ * @file        stream_offload_queue.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "stream_offload_queue.h"
+
+#include <map>
+#include <chrono>
+#include <string.h>
+
+#include <message_handling/message_definitions.h>
+
+#include <libKitsunemimiSakuraNetwork/session.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+// number of slots per session-queue. 0 disables the offloading and the stream-messages are
+// processed directly by the receive-thread of the session.
+std::atomic<uint32_t> g_streamOffloadQueueSize{0};
+
+// number of slots for queues, which are only created for the flow-control
+const uint32_t MIN_STREAM_OFFLOAD_QUEUE_SIZE = 8;
+
+std::map<Sakura::Session*, StreamOffloadQueue*> g_streamOffloadQueues;
+std::mutex g_streamOffloadQueuesLock;
+
+// callbacks of the sessions without queue, to be able to create a queue later. They are only
+// deleted together with their session, because the receive-thread can use them.
+struct SessionStreamCallback
+{
+    std::mutex lock;
+    void* receiver = nullptr;
+    void (*processStream)(void*, Sakura::Session*, const void*, const uint64_t) = nullptr;
+    bool splitRecords = false;
+};
+std::map<Sakura::Session*, SessionStreamCallback*> g_sessionStreamCallbacks;
+
+/**
+ * @brief get the next record of a coalesced stream-message
+ *
+ * @param data pointer to the stream-message
+ * @param dataSize size of the stream-message
+ * @param pos position of the next record, which is moved behind the record
+ * @param record reference for the pointer to the body of the record
+ * @param recordSize reference for the size of the body of the record
+ *
+ * @return false, if no further valid record exist, else true
+ */
+bool
+getNextStreamRecord(const void* data,
+                    const uint64_t dataSize,
+                    uint64_t &pos,
+                    const uint8_t* &record,
+                    uint64_t &recordSize)
+{
+    if(pos == dataSize) {
+        return false;
+    }
+
+    const uint8_t* message = static_cast<const uint8_t*>(data);
+    StreamRecordHeader header;
+    if(pos + sizeof(StreamRecordHeader) > dataSize)
+    {
+        LOG_WARNING("received broken coalesced stream-message");
+        return false;
+    }
+    memcpy(&header, &message[pos], sizeof(StreamRecordHeader));
+
+    const uint64_t bodyPos = pos + sizeof(StreamRecordHeader);
+    if(bodyPos + header.size > dataSize)
+    {
+        LOG_WARNING("received broken coalesced stream-message");
+        return false;
+    }
+
+    record = &message[bodyPos];
+    recordSize = header.size;
+    pos = bodyPos + header.size;
+
+    return true;
+}
+
+/**
+ * @brief stream-callback for sessions without queue, which split coalesced stream-messages
+ *        and call the callback for each record
+ *
+ * @param target pointer to the callback-entry of the session
+ * @param session session, where the message belongs to
+ * @param data pointer to the incoming data
+ * @param dataSize size of the incoming data
+ */
+void
+splitStreamCallback(void* target,
+                    Sakura::Session* session,
+                    const void* data,
+                    const uint64_t dataSize)
+{
+    SessionStreamCallback* callback = static_cast<SessionStreamCallback*>(target);
+    std::lock_guard<std::mutex> guard(callback->lock);
+
+    if(callback->processStream == nullptr) {
+        return;
+    }
+
+    uint64_t pos = 0;
+    const uint8_t* record = nullptr;
+    uint64_t recordSize = 0;
+    while(getNextStreamRecord(data, dataSize, pos, record, recordSize)) {
+        callback->processStream(callback->receiver, session, record, recordSize);
+    }
+}
+
+/**
+ * @brief constructor
+ *
+ * @param session session, where the stream-messages belong to
+ * @param numberOfSlots maximum number of stream-messages within the queue
+ * @param receiver target-object for the callback
+ * @param processStream callback to process the stream-messages
+ */
+StreamOffloadQueue::StreamOffloadQueue(Sakura::Session* session,
+                                       const uint32_t numberOfSlots,
+                                       void* receiver,
+                                       void (*processStream)(void*,
+                                                             Sakura::Session*,
+                                                             const void*,
+                                                             const uint64_t))
+    : Kitsunemimi::Thread("StreamOffloadQueue")
+{
+    m_session = session;
+    m_slots.resize(numberOfSlots);
+    m_receiver = receiver;
+    m_processStream = processStream;
+}
+
+/**
+ * @brief destructor
+ */
+StreamOffloadQueue::~StreamOffloadQueue()
+{
+    for(Slot &slot : m_slots) {
+        delete[] slot.data;
+    }
+}
+
+/**
+ * @brief stream-callback for the session, which forwards the data into the queue
+ *
+ * @param target pointer to the queue
+ * @param data pointer to the incoming data
+ * @param dataSize size of the incoming data
+ */
+void
+StreamOffloadQueue::streamCallback(void* target,
+                                   Sakura::Session*,
+                                   const void* data,
+                                   const uint64_t dataSize)
+{
+    static_cast<StreamOffloadQueue*>(target)->push(data, dataSize);
+}
+
+/**
+ * @brief copy a stream-message into the next free slot. If all slots are in use, it blocks the
+ *        calling receive-thread until the consumer has processed a slot. So the socket of this
+ *        session is not read anymore and the sender is slowed down by the network-stack, without
+ *        affecting other sessions.
+ *
+ * @param data pointer to the data to add
+ * @param dataSize size of the data to add
+ *
+ * @return false, if the queue was closed while waiting, else true
+ */
+bool
+StreamOffloadQueue::push(const void* data, const uint64_t dataSize)
+{
+    if(m_splitRecords == false) {
+        return pushSlot(data, dataSize, dataSize);
+    }
+
+    // each record of a coalesced stream-message gets its own slot
+    uint64_t pos = 0;
+    const uint8_t* record = nullptr;
+    uint64_t recordSize = 0;
+    while(getNextStreamRecord(data, dataSize, pos, record, recordSize))
+    {
+        if(pushSlot(record, recordSize, recordSize + sizeof(StreamRecordHeader)) == false) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief copy data into the next free slot
+ *
+ * @param data pointer to the data to add
+ * @param dataSize size of the data to add
+ * @param frameBytes bytes of the received message, which belong to the slot
+ *
+ * @return false, if the queue was closed while waiting, else true
+ */
+bool
+StreamOffloadQueue::pushSlot(const void* data,
+                             const uint64_t dataSize,
+                             const uint64_t frameBytes)
+{
+    const uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+
+    // wait until a slot is free
+    if(writePos - m_readPos.load() == m_slots.size())
+    {
+        std::unique_lock<std::mutex> lock(m_waitLock);
+        m_producerWaiting = true;
+        while(writePos - m_readPos.load() == m_slots.size())
+        {
+            if(m_closed)
+            {
+                m_producerWaiting = false;
+                return false;
+            }
+            m_producerCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        m_producerWaiting = false;
+    }
+
+    // copy data into slot
+    Slot* slot = &m_slots[writePos % m_slots.size()];
+    if(slot->capacity < dataSize)
+    {
+        delete[] slot->data;
+        slot->data = new uint8_t[dataSize];
+        slot->capacity = dataSize;
+    }
+    if(dataSize > 0) {
+        memcpy(slot->data, data, dataSize);
+    }
+    slot->size = dataSize;
+    slot->frameBytes = frameBytes;
+
+    // publish slot and wake up the consumer, if it is sleeping
+    m_writePos.store(writePos + 1);
+    if(m_consumerWaiting)
+    {
+        std::lock_guard<std::mutex> guard(m_waitLock);
+        m_consumerCondition.notify_one();
+    }
+
+    return true;
+}
+
+/**
+ * @brief change the callback, which processes the stream-messages
+ *
+ * @param receiver target-object for the callback
+ * @param processStream callback to process the stream-messages
+ */
+void
+StreamOffloadQueue::setCallback(void* receiver,
+                                void (*processStream)(void*,
+                                                      Sakura::Session*,
+                                                      const void*,
+                                                      const uint64_t))
+{
+    std::lock_guard<std::mutex> guard(m_callbackLock);
+    m_receiver = receiver;
+    m_processStream = processStream;
+}
+
+/**
+ * @brief enable the flow-control for the stream-messages of the session, so the number of
+ *        consumed bytes is granted back to the sender
+ *
+ * @param windowSize window-size of the sender in bytes
+ */
+void
+StreamOffloadQueue::enableCreditGrants(const uint64_t windowSize)
+{
+    m_creditWindow = windowSize;
+}
+
+/**
+ * @brief split all following stream-messages into their records
+ */
+void
+StreamOffloadQueue::enableRecordSplitting()
+{
+    m_splitRecords = true;
+}
+
+/**
+ * @brief grant consumed bytes back to the sender. To avoid a control-message for each
+ *        stream-message, the bytes are collected until a quarter of the window is reached.
+ *
+ * @param consumedBytes number of consumed bytes
+ */
+void
+StreamOffloadQueue::grantCredits(const uint64_t consumedBytes)
+{
+    const uint64_t creditWindow = m_creditWindow.load(std::memory_order_relaxed);
+    if(creditWindow == 0) {
+        return;
+    }
+
+    m_pendingCredits += consumedBytes;
+    if(m_pendingCredits < creditWindow / 4) {
+        return;
+    }
+
+    StreamCreditHeader header;
+    header.credits = m_pendingCredits;
+    ErrorContainer error;
+    if(m_session->sendNormalMessage(&header, sizeof(StreamCreditHeader), error) == false)
+    {
+        LOG_ERROR(error);
+        return;
+    }
+
+    m_pendingCredits = 0;
+}
+
+/**
+ * @brief release a producer, which waits for a free slot, and stop the thread of the queue
+ */
+void
+StreamOffloadQueue::close()
+{
+    m_closed = true;
+    {
+        std::lock_guard<std::mutex> guard(m_waitLock);
+        m_producerCondition.notify_one();
+        m_consumerCondition.notify_one();
+    }
+
+    stopThread();
+}
+
+/**
+ * @brief process the stream-messages of the queue in the order of their arrival
+ */
+void
+StreamOffloadQueue::run()
+{
+    while(m_abort == false
+          && m_closed == false)
+    {
+        const uint64_t readPos = m_readPos.load(std::memory_order_relaxed);
+
+        // wait for new data
+        if(m_writePos.load() == readPos)
+        {
+            std::unique_lock<std::mutex> lock(m_waitLock);
+            m_consumerWaiting = true;
+            if(m_writePos.load() == readPos
+                    && m_closed == false)
+            {
+                m_consumerCondition.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            m_consumerWaiting = false;
+            continue;
+        }
+
+        // process slot
+        const Slot* slot = &m_slots[readPos % m_slots.size()];
+        {
+            std::lock_guard<std::mutex> guard(m_callbackLock);
+            if(m_processStream != nullptr) {
+                m_processStream(m_receiver, m_session, slot->data, slot->size);
+            }
+        }
+
+        const uint64_t consumedBytes = slot->frameBytes;
+
+        // release slot and wake up the producer, if it is blocked
+        m_readPos.store(readPos + 1);
+        if(m_producerWaiting)
+        {
+            std::lock_guard<std::mutex> guard(m_waitLock);
+            m_producerCondition.notify_one();
+        }
+
+        grantCredits(consumedBytes);
+    }
+}
+
+/**
+ * @brief set the number of slots for the queues of new sessions
+ *
+ * @param numberOfSlots number of slots. 0 disables the offloading of stream-messages.
+ */
+void
+setStreamOffloadQueueSize(const uint32_t numberOfSlots)
+{
+    g_streamOffloadQueueSize = numberOfSlots;
+}
+
+/**
+ * @brief create a queue for the stream-messages of a session, which is processed by an own
+ *        thread, and connect it with the session
+ *
+ * @param session session to connect to a new queue
+ * @param receiver target-object for the callback
+ * @param processStream callback to process the stream-messages
+ *
+ * @return false, if offloading is disabled or the session has already a queue, else true
+ */
+bool
+addStreamOffloadQueue(Sakura::Session* session,
+                      void* receiver,
+                      void (*processStream)(void*,
+                                            Sakura::Session*,
+                                            const void*,
+                                            const uint64_t))
+{
+    const uint32_t numberOfSlots = g_streamOffloadQueueSize;
+    if(numberOfSlots == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(g_streamOffloadQueuesLock);
+
+    if(g_streamOffloadQueues.find(session) != g_streamOffloadQueues.end()) {
+        return false;
+    }
+
+    StreamOffloadQueue* queue = new StreamOffloadQueue(session,
+                                                       numberOfSlots,
+                                                       receiver,
+                                                       processStream);
+    queue->startThread();
+    g_streamOffloadQueues.emplace(session, queue);
+    session->setStreamCallback(queue, &StreamOffloadQueue::streamCallback);
+
+    return true;
+}
+
+/**
+ * @brief set the callback for the stream-messages of a session. If the session has a queue,
+ *        the callback is called by the thread of the queue, else directly by the session.
+ *
+ * @param session session to update
+ * @param receiver target-object for the callback
+ * @param processStream callback to process the stream-messages
+ */
+void
+setSessionStreamCallback(Sakura::Session* session,
+                         void* receiver,
+                         void (*processStream)(void*,
+                                               Sakura::Session*,
+                                               const void*,
+                                               const uint64_t))
+{
+    std::lock_guard<std::mutex> guard(g_streamOffloadQueuesLock);
+
+    std::map<Sakura::Session*, StreamOffloadQueue*>::const_iterator it;
+    it = g_streamOffloadQueues.find(session);
+    if(it != g_streamOffloadQueues.end())
+    {
+        it->second->setCallback(receiver, processStream);
+        return;
+    }
+
+    SessionStreamCallback* callback = nullptr;
+    std::map<Sakura::Session*, SessionStreamCallback*>::const_iterator callback_it;
+    callback_it = g_sessionStreamCallbacks.find(session);
+    if(callback_it != g_sessionStreamCallbacks.end())
+    {
+        callback = callback_it->second;
+    }
+    else
+    {
+        callback = new SessionStreamCallback();
+        g_sessionStreamCallbacks.emplace(session, callback);
+    }
+
+    std::lock_guard<std::mutex> callbackGuard(callback->lock);
+    callback->receiver = receiver;
+    callback->processStream = processStream;
+
+    // with coalesced stream-messages the session still calls the splitting callback
+    if(callback->splitRecords == false) {
+        session->setStreamCallback(receiver, processStream);
+    }
+}
+
+/**
+ * @brief enable the flow-control for the incoming stream-messages of a session. The consumed
+ *        bytes can only be granted by a queue, so a queue is created for the session, if it
+ *        doesn't already have one.
+ *
+ * @param session session, which should grant credits to the sender
+ * @param windowSize window-size of the sender in bytes
+ *
+ * @return false, if window-size is invalid, else true
+ */
+bool
+enableStreamCreditGrants(Sakura::Session* session, const uint64_t windowSize)
+{
+    if(windowSize == 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(g_streamOffloadQueuesLock);
+
+    std::map<Sakura::Session*, StreamOffloadQueue*>::const_iterator it;
+    it = g_streamOffloadQueues.find(session);
+    if(it != g_streamOffloadQueues.end())
+    {
+        it->second->enableCreditGrants(windowSize);
+        return true;
+    }
+
+    // move the callback of the session into a new queue
+    void* receiver = nullptr;
+    void (*processStream)(void*, Sakura::Session*, const void*, const uint64_t) = nullptr;
+    bool splitRecords = false;
+    std::map<Sakura::Session*, SessionStreamCallback*>::const_iterator callback_it;
+    callback_it = g_sessionStreamCallbacks.find(session);
+    if(callback_it != g_sessionStreamCallbacks.end())
+    {
+        std::lock_guard<std::mutex> callbackGuard(callback_it->second->lock);
+        receiver = callback_it->second->receiver;
+        processStream = callback_it->second->processStream;
+        splitRecords = callback_it->second->splitRecords;
+    }
+
+    uint32_t numberOfSlots = g_streamOffloadQueueSize;
+    if(numberOfSlots < MIN_STREAM_OFFLOAD_QUEUE_SIZE) {
+        numberOfSlots = MIN_STREAM_OFFLOAD_QUEUE_SIZE;
+    }
+
+    StreamOffloadQueue* queue = new StreamOffloadQueue(session,
+                                                       numberOfSlots,
+                                                       receiver,
+                                                       processStream);
+    queue->enableCreditGrants(windowSize);
+    if(splitRecords) {
+        queue->enableRecordSplitting();
+    }
+    queue->startThread();
+    g_streamOffloadQueues.emplace(session, queue);
+    session->setStreamCallback(queue, &StreamOffloadQueue::streamCallback);
+
+    return true;
+}
+
+/**
+ * @brief split all following stream-messages of a session into their records, because the
+ *        sender coalesces multiple stream-messages into one
+ *
+ * @param session session, which receives coalesced stream-messages
+ */
+void
+enableStreamRecordSplitting(Sakura::Session* session)
+{
+    std::lock_guard<std::mutex> guard(g_streamOffloadQueuesLock);
+
+    std::map<Sakura::Session*, StreamOffloadQueue*>::const_iterator it;
+    it = g_streamOffloadQueues.find(session);
+    if(it != g_streamOffloadQueues.end())
+    {
+        it->second->enableRecordSplitting();
+        return;
+    }
+
+    // without queue the session calls a splitting callback, which forwards the records to the
+    // registered callback of the session
+    SessionStreamCallback* callback = nullptr;
+    std::map<Sakura::Session*, SessionStreamCallback*>::const_iterator callback_it;
+    callback_it = g_sessionStreamCallbacks.find(session);
+    if(callback_it != g_sessionStreamCallbacks.end())
+    {
+        callback = callback_it->second;
+    }
+    else
+    {
+        callback = new SessionStreamCallback();
+        g_sessionStreamCallbacks.emplace(session, callback);
+    }
+
+    std::lock_guard<std::mutex> callbackGuard(callback->lock);
+    callback->splitRecords = true;
+    session->setStreamCallback(callback, &splitStreamCallback);
+}
+
+/**
+ * @brief process a stream-message of a session, which was not received by the session itself,
+ *        but for example over a shared memory, in the same way as the session would do it
+ *
+ * @param session session, where the message belongs to
+ * @param data pointer to the incoming data
+ * @param dataSize size of the incoming data
+ */
+void
+deliverStreamMessage(Sakura::Session* session,
+                     const void* data,
+                     const uint64_t dataSize)
+{
+    StreamOffloadQueue* queue = nullptr;
+    SessionStreamCallback* callback = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(g_streamOffloadQueuesLock);
+
+        std::map<Sakura::Session*, StreamOffloadQueue*>::const_iterator it;
+        it = g_streamOffloadQueues.find(session);
+        if(it != g_streamOffloadQueues.end())
+        {
+            queue = it->second;
+        }
+        else
+        {
+            std::map<Sakura::Session*, SessionStreamCallback*>::const_iterator callback_it;
+            callback_it = g_sessionStreamCallbacks.find(session);
+            if(callback_it != g_sessionStreamCallbacks.end()) {
+                callback = callback_it->second;
+            }
+        }
+    }
+
+    // queue and callback are only deleted, when the session is closed, which happens
+    // after the caller is stopped
+    if(queue != nullptr)
+    {
+        queue->push(data, dataSize);
+        return;
+    }
+    if(callback == nullptr) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(callback->lock);
+    if(callback->splitRecords)
+    {
+        guard.unlock();
+        splitStreamCallback(callback, session, data, dataSize);
+        return;
+    }
+
+    if(callback->processStream != nullptr) {
+        callback->processStream(callback->receiver, session, data, dataSize);
+    }
+}
+
+/**
+ * @brief stop and delete the queue of a session, if exist, and forget its callback
+ *
+ * @param session session of the queue
+ */
+void
+removeStreamOffloadQueue(Sakura::Session* session)
+{
+    StreamOffloadQueue* queue = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(g_streamOffloadQueuesLock);
+
+        std::map<Sakura::Session*, SessionStreamCallback*>::iterator callback_it;
+        callback_it = g_sessionStreamCallbacks.find(session);
+        if(callback_it != g_sessionStreamCallbacks.end())
+        {
+            delete callback_it->second;
+            g_sessionStreamCallbacks.erase(callback_it);
+        }
+
+        std::map<Sakura::Session*, StreamOffloadQueue*>::iterator it;
+        it = g_streamOffloadQueues.find(session);
+        if(it == g_streamOffloadQueues.end()) {
+            return;
+        }
+
+        queue = it->second;
+        g_streamOffloadQueues.erase(it);
+    }
+
+    queue->close();
+    delete queue;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,137 @@
+/**
+ * @file        stream_offload_queue.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef STREAM_OFFLOAD_QUEUE_H
+#define STREAM_OFFLOAD_QUEUE_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura {
+class Session;
+}
+namespace Hanami
+{
+
+class StreamOffloadQueue
+        : public Kitsunemimi::Thread
+{
+public:
+    StreamOffloadQueue(Sakura::Session* session,
+                       const uint32_t numberOfSlots,
+                       void* receiver,
+                       void (*processStream)(void*,
+                                             Sakura::Session*,
+                                             const void*,
+                                             const uint64_t));
+    ~StreamOffloadQueue();
+
+    static void streamCallback(void* target,
+                               Sakura::Session* session,
+                               const void* data,
+                               const uint64_t dataSize);
+
+    bool push(const void* data, const uint64_t dataSize);
+    void setCallback(void* receiver,
+                     void (*processStream)(void*,
+                                           Sakura::Session*,
+                                           const void*,
+                                           const uint64_t));
+    void enableCreditGrants(const uint64_t windowSize);
+    void enableRecordSplitting();
+    void close();
+
+protected:
+    void run();
+
+private:
+    // slots are reused and only grow, to avoid allocations for each incoming stream-message
+    struct Slot
+    {
+        uint8_t* data = nullptr;
+        uint64_t capacity = 0;
+        uint64_t size = 0;
+        // bytes of the received message for the flow-control, which includes the record-header
+        uint64_t frameBytes = 0;
+    };
+
+    Sakura::Session* m_session = nullptr;
+    std::vector<Slot> m_slots;
+
+    // single-producer (receive-thread of the session) single-consumer (this thread)
+    std::atomic<uint64_t> m_writePos{0};
+    std::atomic<uint64_t> m_readPos{0};
+    std::atomic<bool> m_closed{false};
+    std::atomic<bool> m_splitRecords{false};
+
+    bool pushSlot(const void* data,
+                  const uint64_t dataSize,
+                  const uint64_t frameBytes);
+
+    // only used to sleep, if the queue is full or empty
+    std::mutex m_waitLock;
+    std::condition_variable m_producerCondition;
+    std::condition_variable m_consumerCondition;
+    std::atomic<bool> m_producerWaiting{false};
+    std::atomic<bool> m_consumerWaiting{false};
+
+    // bytes, which are consumed, but not granted to the sender with enabled flow-control
+    std::atomic<uint64_t> m_creditWindow{0};
+    uint64_t m_pendingCredits = 0;
+
+    void grantCredits(const uint64_t consumedBytes);
+
+    std::mutex m_callbackLock;
+    void* m_receiver = nullptr;
+    void (*m_processStream)(void*, Sakura::Session*, const void*, const uint64_t);
+};
+
+void setStreamOffloadQueueSize(const uint32_t numberOfSlots);
+bool addStreamOffloadQueue(Sakura::Session* session,
+                           void* receiver,
+                           void (*processStream)(void*,
+                                                 Sakura::Session*,
+                                                 const void*,
+                                                 const uint64_t));
+void setSessionStreamCallback(Sakura::Session* session,
+                              void* receiver,
+                              void (*processStream)(void*,
+                                                    Sakura::Session*,
+                                                    const void*,
+                                                    const uint64_t));
+bool enableStreamCreditGrants(Sakura::Session* session, const uint64_t windowSize);
+void enableStreamRecordSplitting(Sakura::Session* session);
+void deliverStreamMessage(Sakura::Session* session,
+                          const void* data,
+                          const uint64_t dataSize);
+void removeStreamOffloadQueue(Sakura::Session* session);
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // STREAM_OFFLOAD_QUEUE_H
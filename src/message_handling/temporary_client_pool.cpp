@@ -0,0 +1,289 @@
+/**
+ * @file        temporary_client_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "temporary_client_pool.h"
+
+#include <vector>
+
+#include <message_handling/stream_offload_queue.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+#include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+TemporaryClientPool* TemporaryClientPool::m_instance = nullptr;
+
+/**
+ * @brief constructor
+ */
+TemporaryClientPool::TemporaryClientPool()
+    : Kitsunemimi::Thread("TemporaryClientPool") {}
+
+/**
+ * @brief static methode to get instance of the interface
+ *
+ * @return pointer to the static instance
+ */
+TemporaryClientPool*
+TemporaryClientPool::getInstance()
+{
+    if(m_instance == nullptr) {
+        m_instance = new TemporaryClientPool();
+    }
+
+    return m_instance;
+}
+
+/**
+ * @brief update the session of a temporary client, which is called by the client, while its
+ *        session-lock is hold, so the session can be marked as broken, while the client is in use
+ *
+ * @param client temporary client
+ * @param oldSession previous session of the client
+ * @param newSession new session of the client
+ */
+void
+TemporaryClientPool::updateSession(HanamiMessagingClient* client,
+                                   Sakura::Session* oldSession,
+                                   Sakura::Session* newSession)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::map<Sakura::Session*, HanamiMessagingClient*>::iterator it;
+    it = m_sessionClients.find(oldSession);
+    if(it != m_sessionClients.end()
+            && it->second == client)
+    {
+        m_sessionClients.erase(it);
+    }
+
+    if(newSession != nullptr) {
+        m_sessionClients[newSession] = client;
+    }
+}
+
+/**
+ * @brief remove all sessions of a temporary client, which is deleted
+ *
+ * @param client temporary client to remove
+ */
+void
+TemporaryClientPool::removeTemporaryClient(HanamiMessagingClient* client)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    std::map<Sakura::Session*, HanamiMessagingClient*>::iterator it = m_sessionClients.begin();
+    while(it != m_sessionClients.end())
+    {
+        if(it->second == client) {
+            it = m_sessionClients.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+/**
+ * @brief take an idle client out of the pool
+ *
+ * @param key key of the client, which is build by remote-identifier and target
+ *
+ * @return pointer to a connected client, if one is idle for the key, else nullptr
+ */
+HanamiMessagingClient*
+TemporaryClientPool::acquireClient(const std::string &key)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    const std::pair<std::multimap<std::string, IdleClient>::iterator,
+                    std::multimap<std::string, IdleClient>::iterator> range =
+            m_idleClients.equal_range(key);
+
+    // elements with the same key are in insertion-order, so search from the newest one
+    std::multimap<std::string, IdleClient>::iterator it = range.second;
+    while(it != range.first)
+    {
+        it--;
+        if(it->second.client->m_sessionBroken) {
+            continue;
+        }
+
+        HanamiMessagingClient* client = it->second.client;
+        m_idleClients.erase(it);
+        m_numberOfIdleClients--;
+        m_numberOfReusedClients++;
+
+        return client;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief give a temporary client back to the pool, to be reused for the same key. Clients
+ *        with enabled coalescing or flow-control are not pooled, because the next user would
+ *        inherit these settings, and clients, whose session failed, while they were in use.
+ *
+ * @param client client, which was created by createTemporaryClient
+ *
+ * @return false, if the client can not be pooled and has to be deleted, else true
+ */
+bool
+TemporaryClientPool::releaseClient(HanamiMessagingClient* client)
+{
+    {
+        std::lock_guard<std::mutex> clientGuard(client->m_sessionLock);
+
+        if(client->m_temporaryClientKey == ""
+                || client->m_session == nullptr
+                || client->m_sessionBroken
+                || client->m_streamCoalescer != nullptr
+                || client->m_streamCredits != nullptr)
+        {
+            return false;
+        }
+
+        // the previous user could have replaced the stream-callback of the session
+        HanamiMessaging* messaging = HanamiMessaging::getInstance();
+        setSessionStreamCallback(client->m_session,
+                                 messaging->streamReceiver,
+                                 messaging->processStreamData);
+    }
+
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if(m_numberOfIdleClients >= m_maxIdleClients) {
+        return false;
+    }
+
+    IdleClient idleClient;
+    idleClient.client = client;
+    idleClient.releaseTime = std::chrono::steady_clock::now();
+    m_idleClients.emplace(client->m_temporaryClientKey, idleClient);
+    m_numberOfIdleClients++;
+
+    return true;
+}
+
+/**
+ * @brief mark the temporary client of a session as broken, after an error of the session or
+ *        when it was closed, no matter if the client is idle or in use. The client is not
+ *        deleted here, because this is called by the thread of the session.
+ *
+ * @param session session with the error
+ */
+void
+TemporaryClientPool::markSessionBroken(Sakura::Session* session)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    // the session-lock of the client is not taken here, because the session could be closed by
+    // the client itself, while holding its lock
+    std::map<Sakura::Session*, HanamiMessagingClient*>::const_iterator it;
+    it = m_sessionClients.find(session);
+    if(it != m_sessionClients.end()) {
+        it->second->m_sessionBroken = true;
+    }
+}
+
+/**
+ * @brief set limits of the pool
+ *
+ * @param idleTime time in milliseconds, after which an idle client is closed
+ * @param maxIdleClients maximum number of idle clients, where 0 disables the pool
+ */
+void
+TemporaryClientPool::setLimits(const uint32_t idleTime, const uint32_t maxIdleClients)
+{
+    m_idleTime = idleTime;
+    m_maxIdleClients = maxIdleClients;
+}
+
+/**
+ * @brief get number of temporary clients, which were taken from the pool instead of creating
+ *        a new connection
+ *
+ * @return number of reused clients
+ */
+uint64_t
+TemporaryClientPool::getNumberOfReusedClients() const
+{
+    return m_numberOfReusedClients;
+}
+
+/**
+ * @brief close and delete all clients, which are broken, idle for longer than the idle-time
+ *        or exceed the maximum number of idle clients
+ */
+void
+TemporaryClientPool::removeExpiredClients()
+{
+    std::vector<HanamiMessagingClient*> expiredClients;
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const std::chrono::milliseconds idleTime(m_idleTime.load());
+
+        std::multimap<std::string, IdleClient>::iterator it = m_idleClients.begin();
+        while(it != m_idleClients.end())
+        {
+            if(it->second.client->m_sessionBroken
+                    || now - it->second.releaseTime >= idleTime
+                    || m_numberOfIdleClients > m_maxIdleClients)
+            {
+                expiredClients.push_back(it->second.client);
+                it = m_idleClients.erase(it);
+                m_numberOfIdleClients--;
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    // close the sessions without holding the lock, because this can take some time
+    for(HanamiMessagingClient* client : expiredClients) {
+        delete client;
+    }
+}
+
+/**
+ * @brief thread to close expired idle clients
+ */
+void
+TemporaryClientPool::run()
+{
+    while(m_abort == false)
+    {
+        removeExpiredClients();
+        sleepThread(100000);
+    }
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -0,0 +1,93 @@
+/**
+ * @file        temporary_client_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef TEMPORARY_CLIENT_POOL_H
+#define TEMPORARY_CLIENT_POOL_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <libKitsunemimiCommon/threading/thread.h>
+
+namespace Kitsunemimi
+{
+namespace Sakura {
+class Session;
+}
+namespace Hanami
+{
+class HanamiMessagingClient;
+
+class TemporaryClientPool
+        : public Kitsunemimi::Thread
+{
+public:
+    static TemporaryClientPool* getInstance();
+
+    void updateSession(HanamiMessagingClient* client,
+                       Sakura::Session* oldSession,
+                       Sakura::Session* newSession);
+    void removeTemporaryClient(HanamiMessagingClient* client);
+    HanamiMessagingClient* acquireClient(const std::string &key);
+    bool releaseClient(HanamiMessagingClient* client);
+    void markSessionBroken(Sakura::Session* session);
+    void setLimits(const uint32_t idleTime, const uint32_t maxIdleClients);
+
+    uint64_t getNumberOfReusedClients() const;
+
+protected:
+    void run();
+
+private:
+    TemporaryClientPool();
+
+    static TemporaryClientPool* m_instance;
+
+    struct IdleClient
+    {
+        HanamiMessagingClient* client = nullptr;
+        std::chrono::steady_clock::time_point releaseTime;
+    };
+
+    // sessions of all temporary clients, idle and in use, to mark them, if their session fails
+    std::map<Sakura::Session*, HanamiMessagingClient*> m_sessionClients;
+
+    // idle clients per key, where the most recently released one is used first, because its
+    // session is the least likely to be closed by the remote side
+    std::multimap<std::string, IdleClient> m_idleClients;
+    std::mutex m_lock;
+    uint32_t m_numberOfIdleClients = 0;
+
+    std::atomic<uint32_t> m_idleTime{30000};
+    std::atomic<uint32_t> m_maxIdleClients{16};
+    std::atomic<uint64_t> m_numberOfReusedClients{0};
+
+    void removeExpiredClients();
+};
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
+
+#endif // TEMPORARY_CLIENT_POOL_H
@@ -0,0 +1,151 @@
+/**
+ * @file        network_address.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include <libKitsunemimiHanamiNetwork/network_address.h>
+
+#include <string.h>
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief check if the address is reached over a tcp-connection
+ *
+ * @return true, if ipv4- or ipv6-address, else false
+ */
+bool
+NetworkAddress::isTcp() const
+{
+    return type == IPV4_ADDRESS || type == IPV6_ADDRESS;
+}
+
+/**
+ * @brief classify an address from the config
+ *
+ * @param address ipv4-address, ipv6-address with or without brackets or path to a
+ *                unix-domain-socket
+ *
+ * @return parsed address, which has the type INVALID_ADDRESS, if the address is empty
+ */
+NetworkAddress
+parseNetworkAddress(const std::string &address)
+{
+    NetworkAddress result;
+    if(address == "") {
+        return result;
+    }
+
+    if(inet_pton(AF_INET, address.c_str(), result.ip) == 1)
+    {
+        result.type = IPV4_ADDRESS;
+        result.address = address;
+        return result;
+    }
+
+    // ipv6-addresses can be written in brackets to separate them from the port
+    std::string ipv6 = address;
+    if(ipv6.size() > 2
+            && ipv6.front() == '['
+            && ipv6.back() == ']')
+    {
+        ipv6 = ipv6.substr(1, ipv6.size() - 2);
+    }
+    if(inet_pton(AF_INET6, ipv6.c_str(), result.ip) == 1)
+    {
+        result.type = IPV6_ADDRESS;
+        result.address = ipv6;
+        return result;
+    }
+
+    // everything else is handled as path of a unix-domain-socket
+    result.type = UDS_ADDRESS;
+    result.address = address;
+
+    return result;
+}
+
+/**
+ * @brief check if an ip-address belongs to the local host
+ *
+ * @param address ip-address to check
+ *
+ * @return true, if loopback-address or address of a local interface, else false
+ */
+bool
+isLocalAddress(const NetworkAddress &address)
+{
+    if(address.type == IPV4_ADDRESS
+            && address.ip[0] == 127)
+    {
+        return true;
+    }
+    if(address.type == IPV6_ADDRESS
+            && memcmp(address.ip, &in6addr_loopback, 16) == 0)
+    {
+        return true;
+    }
+    if(address.isTcp() == false) {
+        return false;
+    }
+
+    struct ifaddrs* interfaces = nullptr;
+    if(getifaddrs(&interfaces) != 0) {
+        return false;
+    }
+
+    bool found = false;
+    for(struct ifaddrs* it = interfaces; it != nullptr; it = it->ifa_next)
+    {
+        if(it->ifa_addr == nullptr) {
+            continue;
+        }
+
+        if(address.type == IPV4_ADDRESS
+                && it->ifa_addr->sa_family == AF_INET)
+        {
+            const struct sockaddr_in* interfaceAddr =
+                    reinterpret_cast<const struct sockaddr_in*>(it->ifa_addr);
+            found = memcmp(address.ip, &interfaceAddr->sin_addr, 4) == 0;
+        }
+        if(address.type == IPV6_ADDRESS
+                && it->ifa_addr->sa_family == AF_INET6)
+        {
+            const struct sockaddr_in6* interfaceAddr =
+                    reinterpret_cast<const struct sockaddr_in6*>(it->ifa_addr);
+            found = memcmp(address.ip, &interfaceAddr->sin6_addr, 16) == 0;
+        }
+
+        if(found) {
+            break;
+        }
+    }
+    freeifaddrs(interfaces);
+
+    return found;
+}
+
+}  // namespace Hanami
+}  // namespace Kitsunemimi
@@ -45,6 +45,9 @@ bool checkBlossomValues(const std::map<std::string, FieldDef> &defs,
 bool checkType(DataItem* item,
                const FieldType fieldType);
 
+const std::string createErrorMessage(const std::string &name,
+                                     const FieldType fieldType);
+
 } // namespace Hanami
 } // namespace Kitsunemimi
 
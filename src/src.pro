@@ -50,36 +50,73 @@ LIBS += -L../../libKitsunemimiHanamiCommon/src/debug -lKitsunemimiHanamiCommon
 LIBS += -L../../libKitsunemimiHanamiCommon/src/release -lKitsunemimiHanamiCommon
 INCLUDEPATH += ../../libKitsunemimiHanamiCommon/include
 
-LIBS += -lssl -lcryptopp -lcrypto -pthread -lprotobuf
+LIBS += -lssl -lcryptopp -lcrypto -pthread -lprotobuf -lrt
 
 INCLUDEPATH += $$PWD \
                $$PWD/../include
 
 HEADERS += \
     ../include/libKitsunemimiHanamiNetwork/blossom.h \
+    ../include/libKitsunemimiHanamiNetwork/buffered_response_message.h \
     ../include/libKitsunemimiHanamiNetwork/hanami_messaging.h \
     ../include/libKitsunemimiHanamiNetwork/hanami_messaging_client.h \
+    ../include/libKitsunemimiHanamiNetwork/network_address.h \
     items/item_methods.h \
     items/sakura_items.h \
     items/value_item_map.h \
     items/value_items.h \
     message_handling/message_definitions.h \
     message_handling/permission.h \
+    message_handling/rate_limiter.h \
+    message_handling/error_log_shipper.h \
+    message_handling/generic_message_dispatcher.h \
+    message_handling/stream_offload_queue.h \
+    message_handling/stream_flow_control.h \
+    message_handling/stream_coalescer.h \
+    message_handling/stream_multicast.h \
+    message_handling/shared_memory_ring.h \
+    message_handling/shared_memory_transport.h \
+    message_handling/temporary_client_pool.h \
     callbacks.h \
     message_handling/messaging_event_queue.h \
     message_handling/messaging_event.h \
+    message_handling/messaging_event_worker.h \
+    message_handling/messaging_event_pool.h \
+    message_handling/request_arena.h \
+    message_handling/concurrency_limiter.h \
+    message_handling/json_frame_writer.h \
+    message_handling/json_input_parser.h \
+    message_handling/json_scanner.h \
     runtime_validation.h
 
 SOURCES += \
     blossom.cpp \
+    buffered_response_message.cpp \
     hanami_messaging.cpp \
     hanami_messaging_client.cpp \
+    network_address.cpp \
     items/item_methods.cpp \
     items/sakura_items.cpp \
     items/value_item_map.cpp \
     message_handling/messaging_event_queue.cpp \
     message_handling/messaging_event.cpp \
+    message_handling/messaging_event_worker.cpp \
+    message_handling/messaging_event_pool.cpp \
+    message_handling/request_arena.cpp \
+    message_handling/concurrency_limiter.cpp \
+    message_handling/json_frame_writer.cpp \
+    message_handling/json_input_parser.cpp \
     message_handling/permission.cpp \
+    message_handling/rate_limiter.cpp \
+    message_handling/error_log_shipper.cpp \
+    message_handling/generic_message_dispatcher.cpp \
+    message_handling/stream_offload_queue.cpp \
+    message_handling/stream_flow_control.cpp \
+    message_handling/stream_coalescer.cpp \
+    message_handling/stream_multicast.cpp \
+    message_handling/shared_memory_ring.cpp \
+    message_handling/shared_memory_transport.cpp \
+    message_handling/temporary_client_pool.cpp \
     runtime_validation.cpp
 
 
@@ -0,0 +1,150 @@
+/**
+ * @file       json_parser_benchmark.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "json_parser_benchmark.h"
+
+#include <chrono>
+#include <iostream>
+
+#include <message_handling/json_input_parser.h>
+
+#include <libKitsunemimiCommon/items/data_items.h>
+#include <libKitsunemimiCommon/logger.h>
+#include <libKitsunemimiJson/json_item.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ */
+JsonParser_Benchmark::JsonParser_Benchmark()
+{
+    runBenchmark("small request", "{\"name\":\"test_cluster\",\"number\":42}", 10000);
+    runBenchmark("array of 100000 values", createArrayPayload(100000), 20);
+    runBenchmark("array of 10000 objects", createObjectPayload(10000), 20);
+}
+
+/**
+ * @brief parse the same input multiple times with the JsonItem-parser and with the
+ *        JsonInputParser and print the average duration of both
+ *
+ * @param name name of the benchmark for the output
+ * @param input json-string to parse
+ * @param numberOfRuns number of parser-runs for each parser
+ */
+void
+JsonParser_Benchmark::runBenchmark(const std::string &name,
+                                   const std::string &input,
+                                   const uint32_t numberOfRuns)
+{
+    std::chrono::high_resolution_clock::time_point start;
+    std::chrono::high_resolution_clock::time_point end;
+
+    // JsonItem-parser
+    start = std::chrono::high_resolution_clock::now();
+    for(uint32_t i = 0; i < numberOfRuns; i++)
+    {
+        ErrorContainer error;
+        JsonItem parsedItem;
+        if(parsedItem.parse(input, error) == false) {
+            std::cout<<"JsonItem-parser failed for benchmark: "<<name<<std::endl;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    const double jsonItemDuration = std::chrono::duration<double, std::micro>(end - start).count()
+                                    / static_cast<double>(numberOfRuns);
+
+    // JsonInputParser
+    start = std::chrono::high_resolution_clock::now();
+    for(uint32_t i = 0; i < numberOfRuns; i++)
+    {
+        std::string errorMessage;
+        DataMap result;
+        JsonInputParser parser;
+        if(parser.parse(result, input.c_str(), input.size(), nullptr, errorMessage) == false) {
+            std::cout<<"JsonInputParser failed for benchmark: "<<name<<std::endl;
+        }
+    }
+    end = std::chrono::high_resolution_clock::now();
+    const double inputParserDuration = std::chrono::duration<double, std::micro>(end - start).count()
+                                       / static_cast<double>(numberOfRuns);
+
+    std::cout<<"======================================================================"<<std::endl;
+    std::cout<<name<<" ("<<input.size()<<" bytes)"<<std::endl;
+    std::cout<<"    JsonItem-parser:  "<<jsonItemDuration<<" us"<<std::endl;
+    std::cout<<"    JsonInputParser:  "<<inputParserDuration<<" us"<<std::endl;
+    std::cout<<"    speedup:          "<<jsonItemDuration / inputParserDuration<<std::endl;
+}
+
+/**
+ * @brief create input with a big array of float-values
+ *
+ * @param numberOfValues number of values within the array
+ *
+ * @return json-string
+ */
+const std::string
+JsonParser_Benchmark::createArrayPayload(const uint32_t numberOfValues)
+{
+    std::string payload = "{\"name\":\"benchmark\",\"values\":[";
+    for(uint32_t i = 0; i < numberOfValues; i++)
+    {
+        if(i != 0) {
+            payload.append(",");
+        }
+        payload.append(std::to_string(i) + "." + std::to_string(i % 1000));
+    }
+    payload.append("]}");
+
+    return payload;
+}
+
+/**
+ * @brief create input with an array of objects with string-values
+ *
+ * @param numberOfObjects number of objects within the array
+ *
+ * @return json-string
+ */
+const std::string
+JsonParser_Benchmark::createObjectPayload(const uint32_t numberOfObjects)
+{
+    std::string payload = "{\n    \"items\": [\n";
+    for(uint32_t i = 0; i < numberOfObjects; i++)
+    {
+        if(i != 0) {
+            payload.append(",\n");
+        }
+        payload.append("        {\"id\": " + std::to_string(i) + ", "
+                       "\"uuid\": \"67b8db6b-bc44-4c0f-89dd-1630f1cf9fca\", "
+                       "\"comment\": \"this is a longer comment-string of an item\"}");
+    }
+    payload.append("\n    ]\n}");
+
+    return payload;
+}
+
+} // namespace Hanami
+} // namespace Kitsunemimi
@@ -0,0 +1,51 @@
+/**
+ * @file       json_parser_benchmark.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef JSON_PARSER_BENCHMARK_H
+#define JSON_PARSER_BENCHMARK_H
+
+#include <string>
+#include <stdint.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class JsonParser_Benchmark
+{
+public:
+    JsonParser_Benchmark();
+
+private:
+    void runBenchmark(const std::string &name,
+                      const std::string &input,
+                      const uint32_t numberOfRuns);
+
+    const std::string createArrayPayload(const uint32_t numberOfValues);
+    const std::string createObjectPayload(const uint32_t numberOfObjects);
+};
+
+} // namespace Hanami
+} // namespace Kitsunemimi
+
+#endif // JSON_PARSER_BENCHMARK_H
@@ -63,13 +63,23 @@ LIBS += -L../../../libKitsunemimiCommon/src/debug -lKitsunemimiCommon
 LIBS += -L../../../libKitsunemimiCommon/src/release -lKitsunemimiCommon
 INCLUDEPATH += ../../../libKitsunemimiCommon/include
 
-LIBS += -lssl -lcryptopp -lcrypto -pthread -lprotobuf
+LIBS += -lssl -lcryptopp -lcrypto -pthread -lprotobuf -lrt
 
 SOURCES += \
+    json_frame_writer_test.cpp \
+    json_input_parser_test.cpp \
     main.cpp \
+    messaging_event_pool_test.cpp \
+    network_address_test.cpp \
     session_test.cpp \
+    shared_memory_ring_test.cpp \
     test_blossom.cpp
 
 HEADERS += \
+    json_frame_writer_test.h \
+    json_input_parser_test.h \
+    messaging_event_pool_test.h \
+    network_address_test.h \
     session_test.h \
+    shared_memory_ring_test.h \
     test_blossom.h
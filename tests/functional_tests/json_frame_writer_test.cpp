@@ -0,0 +1,177 @@
+/**
+ * @file       json_frame_writer_test.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "json_frame_writer_test.h"
+
+#include <vector>
+#include <limits>
+#include <string.h>
+#include <stdlib.h>
+
+#include <message_handling/json_frame_writer.h>
+#include <message_handling/request_arena.h>
+#include <message_handling/message_definitions.h>
+
+#include <libKitsunemimiCommon/items/data_items.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ */
+JsonFrameWriter_Test::JsonFrameWriter_Test()
+    : Kitsunemimi::CompareTestHelper("JsonFrameWriter_Test")
+{
+    writeString_test();
+    writeDouble_test();
+    writeNonFinite_test();
+    finishResponseFrame_test();
+    growInPlace_test();
+}
+
+/**
+ * @brief check escaping of quotes, backslashes and control-characters
+ */
+void
+JsonFrameWriter_Test::writeString_test()
+{
+    DataMap map;
+    map.insert("text", new DataValue(std::string("a\"b\\c\n\t\x01\x1f" "d")));
+    map.insert("key\"", new DataValue(std::string("")));
+
+    TEST_EQUAL(writeToString(&map),
+               std::string("{\"key\\\"\":\"\",\"text\":\"a\\\"b\\\\c\\n\\t\\u0001\\u001fd\"}"));
+}
+
+/**
+ * @brief check, that doubles are parsed back into exactly the same value and are still
+ *        recognized as float
+ */
+void
+JsonFrameWriter_Test::writeDouble_test()
+{
+    const std::vector<double> values = {0.1,
+                                        1.0 / 3.0,
+                                        -2.5,
+                                        1e300,
+                                        5e-324,
+                                        std::numeric_limits<double>::max()};
+
+    for(const double value : values)
+    {
+        DataValue item(value);
+        const std::string output = writeToString(&item);
+        TEST_EQUAL(strtod(output.c_str(), nullptr), value);
+    }
+
+    DataValue integralValue(100.0);
+    TEST_EQUAL(writeToString(&integralValue), std::string("100.0"));
+}
+
+/**
+ * @brief check, that nan and infinity are written as null, because json has no representation
+ *        for them
+ */
+void
+JsonFrameWriter_Test::writeNonFinite_test()
+{
+    DataArray array;
+    array.append(new DataValue(std::numeric_limits<double>::quiet_NaN()));
+    array.append(new DataValue(std::numeric_limits<double>::infinity()));
+    array.append(new DataValue(-std::numeric_limits<double>::infinity()));
+    array.append(new DataValue(1.5));
+
+    TEST_EQUAL(writeToString(&array), std::string("[null,null,null,1.5]"));
+}
+
+/**
+ * @brief check, that the reserved header-slot is filled with the size of the json-content
+ */
+void
+JsonFrameWriter_Test::finishResponseFrame_test()
+{
+    RequestArena arena;
+    JsonFrameWriter writer(arena, sizeof(ResponseHeader));
+
+    DataMap map;
+    map.insert("name", new DataValue(std::string("test")));
+    map.insert("value", new DataValue(42));
+    writer.writeItem(&map);
+
+    const std::string expectedContent = "{\"name\":\"test\",\"value\":42}";
+    uint8_t* frame = writer.finishResponseFrame(true, CONFLICT_RTYPE);
+    TEST_EQUAL(frame, writer.getFrame());
+    TEST_EQUAL(writer.getFrameSize(), sizeof(ResponseHeader) + expectedContent.size());
+
+    ResponseHeader header;
+    memcpy(&header, frame, sizeof(ResponseHeader));
+    TEST_EQUAL(header.type, RESPONSE_MESSAGE);
+    TEST_EQUAL(header.success, true);
+    TEST_EQUAL(header.responseType, CONFLICT_RTYPE);
+    TEST_EQUAL(header.messageSize, expectedContent.size());
+
+    const std::string content(reinterpret_cast<char*>(&frame[sizeof(ResponseHeader)]),
+                              header.messageSize);
+    TEST_EQUAL(content, expectedContent);
+}
+
+/**
+ * @brief check, that the frame grows in-place within the arena, as long as nothing else was
+ *        allocated behind it
+ */
+void
+JsonFrameWriter_Test::growInPlace_test()
+{
+    RequestArena arena;
+    JsonFrameWriter writer(arena, sizeof(ResponseHeader), 16);
+    uint8_t* frame = writer.getFrame();
+
+    const std::string longString(1000, 'x');
+    DataValue item(longString);
+    writer.writeItem(&item);
+
+    TEST_EQUAL(writer.getFrame(), frame);
+    TEST_EQUAL(writer.getContentSize(), longString.size() + 2);
+}
+
+/**
+ * @brief write an item into a new frame without header
+ *
+ * @param item item to write
+ *
+ * @return written json-content as string
+ */
+const std::string
+JsonFrameWriter_Test::writeToString(DataItem* item)
+{
+    RequestArena arena;
+    JsonFrameWriter writer(arena, 0, 16);
+    writer.writeItem(item);
+
+    return std::string(reinterpret_cast<char*>(writer.getFrame()), writer.getContentSize());
+}
+
+} // namespace Hanami
+} // namespace Kitsunemimi
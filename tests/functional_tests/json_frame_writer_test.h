@@ -0,0 +1,56 @@
+/**
+ * @file       json_frame_writer_test.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef JSON_FRAME_WRITER_TEST_H
+#define JSON_FRAME_WRITER_TEST_H
+
+#include <iostream>
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Kitsunemimi
+{
+class DataItem;
+
+namespace Hanami
+{
+
+class JsonFrameWriter_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    JsonFrameWriter_Test();
+
+private:
+    void writeString_test();
+    void writeDouble_test();
+    void writeNonFinite_test();
+    void finishResponseFrame_test();
+    void growInPlace_test();
+
+    const std::string writeToString(DataItem* item);
+};
+
+} // namespace Hanami
+} // namespace Kitsunemimi
+
+#endif // JSON_FRAME_WRITER_TEST_H
@@ -0,0 +1,128 @@
+/**
+ * @file       json_input_parser_test.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "json_input_parser_test.h"
+
+#include <test_blossom.h>
+
+#include <message_handling/json_input_parser.h>
+#include <libKitsunemimiCommon/items/data_items.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ */
+JsonInputParser_Test::JsonInputParser_Test()
+    : Kitsunemimi::CompareTestHelper("JsonInputParser_Test")
+{
+    parse_generic_test();
+    parse_syntaxError_test();
+    parse_schema_test();
+}
+
+/**
+ * @brief parse input without a blossom to validate against
+ */
+void
+JsonInputParser_Test::parse_generic_test()
+{
+    const std::string input = "{ \"int\": -42, \"float\": 1.5e2, \"bool\": true, "
+                              "\"string\": \"a\\\"b\\u00e4\", \"array\": [1, {\"x\": null}], "
+                              "\"map\": {}}";
+    JsonInputParser parser;
+    DataMap result;
+    std::string errorMessage;
+
+    TEST_EQUAL(parser.parse(result, input.c_str(), input.size(), nullptr, errorMessage), true);
+    TEST_EQUAL(result.size(), 6);
+    TEST_EQUAL(result.get("int")->isIntValue(), true);
+    TEST_EQUAL(result.get("int")->toValue()->getLong(), -42);
+    TEST_EQUAL(result.get("float")->toValue()->getDouble(), 150.0);
+    TEST_EQUAL(result.get("bool")->toValue()->getBool(), true);
+    TEST_EQUAL(result.get("string")->toValue()->getString(), std::string("a\"b\xC3\xA4"));
+    TEST_EQUAL(result.get("array")->toArray()->array.size(), 2);
+    TEST_EQUAL(result.get("map")->isMap(), true);
+}
+
+/**
+ * @brief check that broken input is rejected with the position of the offending byte
+ */
+void
+JsonInputParser_Test::parse_syntaxError_test()
+{
+    JsonInputParser parser;
+    std::string errorMessage;
+
+    DataMap result1;
+    const std::string input1 = "{\"a\": [1, 2}";
+    TEST_EQUAL(parser.parse(result1, input1.c_str(), input1.size(), nullptr, errorMessage), false);
+    TEST_EQUAL(errorMessage.find("position 11") != std::string::npos, true);
+
+    DataMap result2;
+    const std::string input2 = "{\"a\": 1} x";
+    TEST_EQUAL(parser.parse(result2, input2.c_str(), input2.size(), nullptr, errorMessage), false);
+
+    DataMap result3;
+    const std::string input3 = "[1]";
+    TEST_EQUAL(parser.parse(result3, input3.c_str(), input3.size(), nullptr, errorMessage), false);
+}
+
+/**
+ * @brief check validation against the input-fields of a blossom while parsing
+ */
+void
+JsonInputParser_Test::parse_schema_test()
+{
+    TestBlossom blossom(nullptr);
+    JsonInputParser parser;
+    std::string errorMessage;
+
+    // valid input, token is always allowed
+    DataMap result1;
+    const std::string input1 = "{\"input\": 42, \"token\": \"asdf\"}";
+    TEST_EQUAL(parser.parse(result1, input1.c_str(), input1.size(), &blossom, errorMessage), true);
+    TEST_EQUAL(result1.size(), 2);
+
+    // false type
+    DataMap result2;
+    const std::string input2 = "{\"input\": 4.2}";
+    TEST_EQUAL(parser.parse(result2, input2.c_str(), input2.size(), &blossom, errorMessage), false);
+    TEST_EQUAL(result2.size(), 0);
+
+    // unknown field
+    DataMap result3;
+    const std::string input3 = "{\"input\": 42, \"fail\": [1, 2, 3]}";
+    TEST_EQUAL(parser.parse(result3, input3.c_str(), input3.size(), &blossom, errorMessage), false);
+    TEST_EQUAL(result3.contains("fail"), false);
+
+    // missing required field
+    DataMap result4;
+    const std::string input4 = "{}";
+    TEST_EQUAL(parser.parse(result4, input4.c_str(), input4.size(), &blossom, errorMessage), false);
+}
+
+} // namespace Hanami
+} // namespace Kitsunemimi
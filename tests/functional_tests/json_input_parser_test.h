@@ -0,0 +1,50 @@
+/**
+ * @file       json_input_parser_test.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef JSON_INPUT_PARSER_TEST_H
+#define JSON_INPUT_PARSER_TEST_H
+
+#include <iostream>
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class JsonInputParser_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    JsonInputParser_Test();
+
+private:
+    void parse_generic_test();
+    void parse_syntaxError_test();
+    void parse_schema_test();
+};
+
+} // namespace Hanami
+} // namespace Kitsunemimi
+
+#endif // JSON_INPUT_PARSER_TEST_H
@@ -23,11 +23,22 @@
 #include <libKitsunemimiCommon/logger.h>
 #include <libKitsunemimiConfig/config_handler.h>
 #include <session_test.h>
+#include <messaging_event_pool_test.h>
+#include <json_input_parser_test.h>
+#include <shared_memory_ring_test.h>
+#include <network_address_test.h>
+#include <json_frame_writer_test.h>
 
 int main()
 {
     Kitsunemimi::initConsoleLogger(true);
 
+    Kitsunemimi::Hanami::MessagingEventPool_Test eventPoolTest;
+    Kitsunemimi::Hanami::JsonInputParser_Test jsonInputParserTest;
+    Kitsunemimi::Hanami::SharedMemoryRing_Test sharedMemoryRingTest;
+    Kitsunemimi::Hanami::NetworkAddress_Test networkAddressTest;
+    Kitsunemimi::Hanami::JsonFrameWriter_Test jsonFrameWriterTest;
+
     //Kitsunemimi::Sakura::Session_Test tcpTest("127.0.0.1");
     Kitsunemimi::Hanami::Session_Test udsTest("/tmp/test.uds");
 }
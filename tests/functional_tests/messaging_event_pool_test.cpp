@@ -0,0 +1,268 @@
+/**
+ * @file       messaging_event_pool_test.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "messaging_event_pool_test.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string.h>
+
+#include <message_handling/messaging_event.h>
+#include <message_handling/messaging_event_pool.h>
+#include <message_handling/messaging_event_queue.h>
+#include <message_handling/message_definitions.h>
+
+#include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
+
+#include <test_blossom.h>
+
+// counter for all heap-allocations of the test-binary, which is only increased while
+// the counting is enabled by the allocation-tests, so the other tests are not affected
+std::atomic<uint64_t> g_numberOfAllocations(0);
+std::atomic<bool> g_countAllocations(false);
+
+void*
+operator new(std::size_t size)
+{
+    if(g_countAllocations) {
+        g_numberOfAllocations++;
+    }
+
+    void* ptr = malloc(size);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void
+operator delete(void* ptr, std::size_t) noexcept
+{
+    free(ptr);
+}
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+const std::string testId = "v1/cluster/template/with/long/id";
+const std::string testToken = "eyJhbGciOiJIUzI1NiIsInR5cCI6IkpXVCJ9.test.token";
+const std::string testInput = "{\"name\":\"test_cluster\",\"template_uuid\":"
+                              "\"67b8db6b-bc44-4c0f-89dd-1630f1cf9fca\",\"number\":42}";
+
+const std::string testBlossomId = "v1/event_pool_test/blossom";
+const std::string testBlossomInput = "{\"input\":42}";
+
+/**
+ * @brief constructor
+ */
+MessagingEventPool_Test::MessagingEventPool_Test()
+    : Kitsunemimi::CompareTestHelper("MessagingEventPool_Test")
+{
+    reuseEvent_test();
+    handoffPath_noAllocation_test();
+    handleRequest_steadyState_test();
+}
+
+/**
+ * @brief check that released events are given out again
+ */
+void
+MessagingEventPool_Test::reuseEvent_test()
+{
+    MessagingEventPool* pool = MessagingEventPool::getInstance();
+
+    MessagingEvent* event = pool->getEvent();
+    const uint64_t numberOfFreeEvents = pool->getNumberOfFreeEvents();
+    pool->releaseEvent(event);
+    TEST_EQUAL(pool->getNumberOfFreeEvents(), numberOfFreeEvents + 1);
+
+    MessagingEvent* reusedEvent = pool->getEvent();
+    TEST_EQUAL(reusedEvent, event);
+    TEST_EQUAL(pool->getNumberOfFreeEvents(), numberOfFreeEvents);
+    pool->releaseEvent(reusedEvent);
+}
+
+/**
+ * @brief check that the handoff of an event from the receive-thread to a worker, so getting it
+ *        from the pool, filling and queuing it and releasing it again, doesn't need any
+ *        allocation after the pool is warmed up.
+ */
+void
+MessagingEventPool_Test::handoffPath_noAllocation_test()
+{
+    // warm-up
+    for(uint32_t i = 0; i < 10; i++) {
+        runHandoffCycle();
+    }
+
+    g_numberOfAllocations = 0;
+    g_countAllocations = true;
+    for(uint32_t i = 0; i < 1000; i++) {
+        runHandoffCycle();
+    }
+    g_countAllocations = false;
+
+    const uint64_t numberOfAllocations = g_numberOfAllocations;
+    TEST_EQUAL(numberOfAllocations, 0);
+}
+
+/**
+ * @brief run one cycle of getting, filling, queuing and releasing an event, like it is done
+ *        for each incoming trigger-message, but without processing the event
+ */
+void
+MessagingEventPool_Test::runHandoffCycle()
+{
+    MessagingEventPool* pool = MessagingEventPool::getInstance();
+    MessagingEventQueue* queue = MessagingEventQueue::getInstance();
+
+    MessagingEvent* event = pool->getEvent();
+    event->initEvent(POST_TYPE,
+                     testId.c_str(),
+                     static_cast<uint32_t>(testId.size()),
+                     testToken.c_str(),
+                     static_cast<uint32_t>(testToken.size()),
+                     testInput.c_str(),
+                     testInput.size(),
+                     nullptr,
+                     0);
+    queue->addTriggerToQueue(event);
+
+    bool isTrigger = false;
+    uint64_t queueWait = 0;
+    Event* queuedEvent = queue->getEventFromQueue(0, isTrigger, queueWait);
+    TEST_EQUAL(queuedEvent, event);
+    TEST_EQUAL(isTrigger, true);
+    queue->finishTrigger(queueWait, 0);
+    pool->releaseEvent(static_cast<MessagingEvent*>(queuedEvent));
+}
+
+/**
+ * @brief check that handling a request against a blossom reaches a steady state after the
+ *        warm-up, where each request needs the same number of allocations. These are only the
+ *        allocations of the data-items of input and output and of the blossom-processing
+ *        itself, because the state of the request is kept within the pooled event.
+ */
+void
+MessagingEventPool_Test::handleRequest_steadyState_test()
+{
+    HanamiMessaging* messaging = HanamiMessaging::getInstance();
+    messaging->addBlossom("event_pool_test", "blossom", new TestBlossom(nullptr));
+    messaging->addEndpoint(testBlossomId,
+                           POST_TYPE,
+                           BLOSSOM_TYPE,
+                           "event_pool_test",
+                           "blossom");
+
+    // check response of a single request
+    MessagingEventPool* pool = MessagingEventPool::getInstance();
+    MessagingEvent* event = pool->getEvent();
+    event->initEvent(POST_TYPE,
+                     testBlossomId.c_str(),
+                     static_cast<uint32_t>(testBlossomId.size()),
+                     "",
+                     0,
+                     testBlossomInput.c_str(),
+                     testBlossomInput.size(),
+                     nullptr,
+                     0);
+    TEST_EQUAL(event->handleRequest(), true);
+
+    const std::string expectedContent = "{\"output\":42}";
+    TEST_EQUAL(event->getResponseFrameSize(), sizeof(ResponseHeader) + expectedContent.size());
+    ResponseHeader header;
+    memcpy(&header, event->getResponseFrame(), sizeof(ResponseHeader));
+    TEST_EQUAL(header.success, true);
+    TEST_EQUAL(header.responseType, OK_RTYPE);
+    const std::string content(
+            reinterpret_cast<const char*>(&event->getResponseFrame()[sizeof(ResponseHeader)]),
+            header.messageSize);
+    TEST_EQUAL(content, expectedContent);
+    pool->releaseEvent(event);
+
+    // warm-up
+    TEST_EQUAL(runRequestCycles(10), 10);
+
+    g_numberOfAllocations = 0;
+    g_countAllocations = true;
+    const uint32_t numberOfSuccessfulRequests1 = runRequestCycles(100);
+    g_countAllocations = false;
+    const uint64_t numberOfAllocations1 = g_numberOfAllocations;
+
+    g_numberOfAllocations = 0;
+    g_countAllocations = true;
+    const uint32_t numberOfSuccessfulRequests2 = runRequestCycles(100);
+    g_countAllocations = false;
+    const uint64_t numberOfAllocations2 = g_numberOfAllocations;
+
+    TEST_EQUAL(numberOfSuccessfulRequests1, 100);
+    TEST_EQUAL(numberOfSuccessfulRequests2, 100);
+    TEST_EQUAL(numberOfAllocations1, numberOfAllocations2);
+}
+
+/**
+ * @brief handle multiple requests against the test-blossom with events of the pool, like it is
+ *        done by the worker, but without sending the response
+ *
+ * @param numberOfCycles number of requests to handle
+ *
+ * @return number of successful requests
+ */
+uint32_t
+MessagingEventPool_Test::runRequestCycles(const uint32_t numberOfCycles)
+{
+    MessagingEventPool* pool = MessagingEventPool::getInstance();
+    uint32_t numberOfSuccessfulRequests = 0;
+
+    for(uint32_t i = 0; i < numberOfCycles; i++)
+    {
+        MessagingEvent* event = pool->getEvent();
+        event->initEvent(POST_TYPE,
+                         testBlossomId.c_str(),
+                         static_cast<uint32_t>(testBlossomId.size()),
+                         "",
+                         0,
+                         testBlossomInput.c_str(),
+                         testBlossomInput.size(),
+                         nullptr,
+                         0);
+        if(event->handleRequest()) {
+            numberOfSuccessfulRequests++;
+        }
+        pool->releaseEvent(event);
+    }
+
+    return numberOfSuccessfulRequests;
+}
+
+} // namespace Hanami
+} // namespace Kitsunemimi
@@ -0,0 +1,53 @@
+/**
+ * @file       messaging_event_pool_test.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef MESSAGING_EVENT_POOL_TEST_H
+#define MESSAGING_EVENT_POOL_TEST_H
+
+#include <iostream>
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class MessagingEventPool_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    MessagingEventPool_Test();
+
+private:
+    void reuseEvent_test();
+    void handoffPath_noAllocation_test();
+    void handleRequest_steadyState_test();
+
+    void runHandoffCycle();
+    uint32_t runRequestCycles(const uint32_t numberOfCycles);
+};
+
+} // namespace Hanami
+} // namespace Kitsunemimi
+
+#endif // MESSAGING_EVENT_POOL_TEST_H
@@ -0,0 +1,82 @@
+/**
+ * @file       network_address_test.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "network_address_test.h"
+
+#include <vector>
+
+#include <libKitsunemimiHanamiNetwork/network_address.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+struct AddressTestCase
+{
+    std::string input;
+    NetworkAddressType type;
+    std::string address;
+    bool isTcp;
+    bool isLocal;
+};
+
+/**
+ * @brief constructor
+ */
+NetworkAddress_Test::NetworkAddress_Test()
+    : Kitsunemimi::CompareTestHelper("NetworkAddress_Test")
+{
+    parseNetworkAddress_test();
+}
+
+/**
+ * @brief check the classification of all supported kinds of addresses
+ */
+void
+NetworkAddress_Test::parseNetworkAddress_test()
+{
+    const std::vector<AddressTestCase> testCases = {
+        // input           type             address            tcp    local
+        {"127.0.0.1",      IPV4_ADDRESS,    "127.0.0.1",       true,  true},
+        {"192.0.2.10",     IPV4_ADDRESS,    "192.0.2.10",      true,  false},
+        {"::1",            IPV6_ADDRESS,    "::1",             true,  true},
+        {"2001:db8::1",    IPV6_ADDRESS,    "2001:db8::1",     true,  false},
+        {"[::1]",          IPV6_ADDRESS,    "::1",             true,  true},
+        {"[2001:db8::1]",  IPV6_ADDRESS,    "2001:db8::1",     true,  false},
+        {"/tmp/hanami.uds",UDS_ADDRESS,     "/tmp/hanami.uds", false, false},
+        {"1.2.3",          UDS_ADDRESS,     "1.2.3",           false, false},
+        {"",               INVALID_ADDRESS, "",                false, false},
+    };
+
+    for(const AddressTestCase &testCase : testCases)
+    {
+        const NetworkAddress result = parseNetworkAddress(testCase.input);
+        TEST_EQUAL(result.type, testCase.type);
+        TEST_EQUAL(result.address, testCase.address);
+        TEST_EQUAL(result.isTcp(), testCase.isTcp);
+        TEST_EQUAL(isLocalAddress(result), testCase.isLocal);
+    }
+}
+
+} // namespace Hanami
+} // namespace Kitsunemimi
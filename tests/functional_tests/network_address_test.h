@@ -0,0 +1,48 @@
+/**
+ * @file       network_address_test.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef NETWORK_ADDRESS_TEST_H
+#define NETWORK_ADDRESS_TEST_H
+
+#include <iostream>
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class NetworkAddress_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    NetworkAddress_Test();
+
+private:
+    void parseNetworkAddress_test();
+};
+
+} // namespace Hanami
+} // namespace Kitsunemimi
+
+#endif // NETWORK_ADDRESS_TEST_H
@@ -36,6 +36,8 @@
 #include <libKitsunemimiHanamiCommon/enums.h>
 #include <libKitsunemimiCommon/files/text_file.h>
 
+#include <message_handling/shared_memory_transport.h>
+
 namespace Kitsunemimi
 {
 namespace Hanami
@@ -97,11 +99,12 @@ void genreicMessageCallback(Sakura::Session* session,
 }
 
 void streamDataCallback(void*,
-                        Sakura::Session*,
+                        Sakura::Session* session,
                         const void* data,
                         const uint64_t dataSize)
 {
     LOG_DEBUG("TEST: streamDataCallback");
+    Session_Test::m_instance->m_streamSession = session;
     const std::string recvMsg(static_cast<const char*>(data), dataSize);
     Session_Test::m_instance->compare(recvMsg, Session_Test::m_instance->m_streamMessage);
 }
@@ -169,6 +172,19 @@ Session_Test::runTest()
     m_numberOfTests++;
     TEST_EQUAL(response.type, NOT_IMPLEMENTED_RTYPE);
 
+    TEST_EQUAL(client->sendStreamMessage(m_streamMessage.c_str(),
+                                         m_streamMessage.size(),
+                                         false,
+                                         error), true);
+
+    sleep(1);
+
+    // stop the reader of the shared memory, like a broken receiver would do, and check that
+    // the client continues to send the stream-messages over the socket
+    if(m_streamSession != nullptr) {
+        removeSharedMemoryReader(m_streamSession);
+    }
+    m_numberOfTests++;
     TEST_EQUAL(client->sendStreamMessage(m_streamMessage.c_str(),
                                          m_streamMessage.size(),
                                          false,
@@ -181,7 +197,7 @@ Session_Test::runTest()
 
     // check that were no tests silently skipped
     m_numberOfTests++;
-    TEST_EQUAL(m_numberOfTests, 9);
+    TEST_EQUAL(m_numberOfTests, 11);
 
     std::cout<<"finish"<<std::endl;
 }
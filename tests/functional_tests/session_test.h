@@ -30,6 +30,9 @@
 
 namespace Kitsunemimi
 {
+namespace Sakura {
+class Session;
+}
 namespace Hanami
 {
 class MessagingClient;
@@ -54,6 +57,7 @@ public:
     std::string m_message = "";
     const std::string m_streamMessage = "stream-message";
     Kitsunemimi::Hanami::MessagingClient* m_client = nullptr;
+    Kitsunemimi::Sakura::Session* m_streamSession = nullptr;
 
     uint32_t m_numberOfTests = 0;
 
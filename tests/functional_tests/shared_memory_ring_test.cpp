@@ -0,0 +1,320 @@
+/**
+ * @file       shared_memory_ring_test.cpp
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "shared_memory_ring_test.h"
+
+#include <thread>
+#include <chrono>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <message_handling/shared_memory_ring.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+/**
+ * @brief constructor
+ */
+SharedMemoryRing_Test::SharedMemoryRing_Test()
+    : Kitsunemimi::CompareTestHelper("SharedMemoryRing_Test")
+{
+    createOpen_test();
+    wrapAround_test();
+    fullRing_test();
+    brokenRecord_test();
+    closeWithWaiters_test();
+}
+
+/**
+ * @brief create and open a ring and send one record from one side to the other
+ */
+void
+SharedMemoryRing_Test::createOpen_test()
+{
+    ErrorContainer error;
+    const std::string name = getRingName("createOpen");
+
+    SharedMemoryRing* writer = SharedMemoryRing::createRing(name, 4096, error);
+    TEST_NOT_EQUAL(writer, nullptr);
+    if(writer == nullptr) {
+        return;
+    }
+    TEST_EQUAL(writer->getMaxRecordSize(), 2040);
+
+    // the name must be unique
+    TEST_EQUAL(SharedMemoryRing::createRing(name, 4096, error), nullptr);
+
+    SharedMemoryRing* reader = SharedMemoryRing::openRing(name, error);
+    TEST_NOT_EQUAL(reader, nullptr);
+    if(reader == nullptr)
+    {
+        delete writer;
+        return;
+    }
+
+    // the name is removed by opening, so it can not be opened a second time
+    TEST_EQUAL(SharedMemoryRing::openRing(name, error), nullptr);
+
+    const std::string testData = "test-record";
+    TEST_EQUAL(writer->writeRecord(testData.c_str(), testData.size(), false), true);
+
+    const void* data = nullptr;
+    uint64_t dataSize = 0;
+    TEST_EQUAL(reader->readRecord(100, data, dataSize), true);
+    TEST_EQUAL(dataSize, testData.size());
+    TEST_EQUAL(std::string(static_cast<const char*>(data), dataSize), testData);
+    reader->releaseRecord();
+
+    TEST_EQUAL(writer->isEmpty(), true);
+    TEST_EQUAL(reader->readRecord(1, data, dataSize), false);
+
+    delete reader;
+    delete writer;
+}
+
+/**
+ * @brief write more records than the ring can hold at once, so records are wrapped at the end
+ *        of the ring and have to be copied by the reader
+ */
+void
+SharedMemoryRing_Test::wrapAround_test()
+{
+    ErrorContainer error;
+    const std::string name = getRingName("wrapAround");
+
+    SharedMemoryRing* writer = SharedMemoryRing::createRing(name, 256, error);
+    SharedMemoryRing* reader = SharedMemoryRing::openRing(name, error);
+    TEST_NOT_EQUAL(writer, nullptr);
+    TEST_NOT_EQUAL(reader, nullptr);
+    if(writer == nullptr
+            || reader == nullptr)
+    {
+        delete writer;
+        delete reader;
+        return;
+    }
+
+    // 100 bytes results in records of 112 bytes, which don't divide the ring evenly
+    uint8_t testData[100];
+    bool allEqual = true;
+    for(uint32_t round = 0; round < 20; round++)
+    {
+        for(uint32_t i = 0; i < 100; i++) {
+            testData[i] = static_cast<uint8_t>(round + i);
+        }
+        TEST_EQUAL(writer->writeRecord(testData, 100, false), true);
+
+        const void* data = nullptr;
+        uint64_t dataSize = 0;
+        TEST_EQUAL(reader->readRecord(100, data, dataSize), true);
+        TEST_EQUAL(dataSize, 100);
+        if(dataSize != 100
+                || memcmp(data, testData, 100) != 0)
+        {
+            allEqual = false;
+        }
+        reader->releaseRecord();
+    }
+    TEST_EQUAL(allEqual, true);
+
+    delete reader;
+    delete writer;
+}
+
+/**
+ * @brief check that a full ring rejects new records without waiting, until the reader has
+ *        released a record
+ */
+void
+SharedMemoryRing_Test::fullRing_test()
+{
+    ErrorContainer error;
+    const std::string name = getRingName("fullRing");
+
+    SharedMemoryRing* writer = SharedMemoryRing::createRing(name, 256, error);
+    SharedMemoryRing* reader = SharedMemoryRing::openRing(name, error);
+    TEST_NOT_EQUAL(writer, nullptr);
+    TEST_NOT_EQUAL(reader, nullptr);
+    if(writer == nullptr
+            || reader == nullptr)
+    {
+        delete writer;
+        delete reader;
+        return;
+    }
+
+    uint8_t testData[100];
+    memset(testData, 42, 100);
+    TEST_EQUAL(writer->writeRecord(testData, 100, false), true);
+    TEST_EQUAL(writer->writeRecord(testData, 100, false), true);
+    TEST_EQUAL(writer->writeRecord(testData, 100, false), false);
+
+    // records bigger than the maximum size are never accepted
+    uint8_t bigData[200];
+    TEST_EQUAL(writer->writeRecord(bigData, 200, false), false);
+
+    const void* data = nullptr;
+    uint64_t dataSize = 0;
+    TEST_EQUAL(reader->readRecord(100, data, dataSize), true);
+    reader->releaseRecord();
+    TEST_EQUAL(writer->writeRecord(testData, 100, false), true);
+    TEST_EQUAL(writer->isClosed(), false);
+
+    delete reader;
+    delete writer;
+}
+
+/**
+ * @brief check that a record with an invalid size, which could be written by a broken process,
+ *        is rejected by the reader and closes the ring
+ */
+void
+SharedMemoryRing_Test::brokenRecord_test()
+{
+    ErrorContainer error;
+    const std::string name = getRingName("brokenRecord");
+
+    SharedMemoryRing* writer = SharedMemoryRing::createRing(name, 256, error);
+    TEST_NOT_EQUAL(writer, nullptr);
+    if(writer == nullptr) {
+        return;
+    }
+
+    uint8_t testData[16];
+    memset(testData, 42, 16);
+    TEST_EQUAL(writer->writeRecord(testData, 16, false), true);
+
+    // map the memory a second time to overwrite the size of the first record
+    const int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    TEST_EQUAL(fd >= 0, true);
+    if(fd < 0)
+    {
+        delete writer;
+        return;
+    }
+    const uint64_t mappedSize = sizeof(SharedMemoryRingHeader) + 256;
+    void* mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    TEST_NOT_EQUAL(mapped, MAP_FAILED);
+    if(mapped == MAP_FAILED)
+    {
+        delete writer;
+        return;
+    }
+    const uint64_t brokenSize = 100000;
+    memcpy(static_cast<uint8_t*>(mapped) + sizeof(SharedMemoryRingHeader),
+           &brokenSize,
+           sizeof(uint64_t));
+    munmap(mapped, mappedSize);
+
+    SharedMemoryRing* reader = SharedMemoryRing::openRing(name, error);
+    TEST_NOT_EQUAL(reader, nullptr);
+    if(reader == nullptr)
+    {
+        delete writer;
+        return;
+    }
+
+    const void* data = nullptr;
+    uint64_t dataSize = 0;
+    TEST_EQUAL(reader->readRecord(100, data, dataSize), false);
+    TEST_EQUAL(reader->isClosed(), true);
+    TEST_EQUAL(writer->isClosed(), true);
+    TEST_EQUAL(writer->writeRecord(testData, 16, true), false);
+
+    delete reader;
+    delete writer;
+}
+
+/**
+ * @brief check that closing the ring releases a writer, which waits for free space, and a
+ *        writer, which waits for the ring to become empty
+ */
+void
+SharedMemoryRing_Test::closeWithWaiters_test()
+{
+    ErrorContainer error;
+    const std::string name = getRingName("closeWithWaiters");
+
+    SharedMemoryRing* writer = SharedMemoryRing::createRing(name, 256, error);
+    SharedMemoryRing* reader = SharedMemoryRing::openRing(name, error);
+    TEST_NOT_EQUAL(writer, nullptr);
+    TEST_NOT_EQUAL(reader, nullptr);
+    if(writer == nullptr
+            || reader == nullptr)
+    {
+        delete writer;
+        delete reader;
+        return;
+    }
+
+    uint8_t testData[100];
+    memset(testData, 42, 100);
+    TEST_EQUAL(writer->writeRecord(testData, 100, false), true);
+    TEST_EQUAL(writer->writeRecord(testData, 100, false), true);
+
+    bool writeResult = true;
+    bool emptyResult = true;
+    std::thread writeThread([&]() {
+        writeResult = writer->writeRecord(testData, 100, true);
+    });
+    std::thread emptyThread([&]() {
+        emptyResult = writer->waitUntilEmpty();
+    });
+
+    // both threads should be blocked until the reader closes the ring
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    reader->close();
+    writeThread.join();
+    emptyThread.join();
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    TEST_EQUAL(writeResult, false);
+    TEST_EQUAL(emptyResult, false);
+    TEST_EQUAL(writer->isClosed(), true);
+    TEST_EQUAL(end - start < std::chrono::seconds(1), true);
+
+    delete reader;
+    delete writer;
+}
+
+/**
+ * @brief get unique name for the shared memory of a test
+ *
+ * @param testName name of the test
+ *
+ * @return name for the shared memory
+ */
+std::string
+SharedMemoryRing_Test::getRingName(const std::string &testName)
+{
+    return "/hanami-shm-test-" + testName + "-" + std::to_string(getpid());
+}
+
+} // namespace Hanami
+} // namespace Kitsunemimi
@@ -0,0 +1,54 @@
+/**
+ * @file       shared_memory_ring_test.h
+ *
+ * @author     Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright  Apache License Version 2.0
+ *
+ *      Copyright 2022 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef SHARED_MEMORY_RING_TEST_H
+#define SHARED_MEMORY_RING_TEST_H
+
+#include <iostream>
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+namespace Kitsunemimi
+{
+namespace Hanami
+{
+
+class SharedMemoryRing_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    SharedMemoryRing_Test();
+
+private:
+    void createOpen_test();
+    void wrapAround_test();
+    void fullRing_test();
+    void brokenRecord_test();
+    void closeWithWaiters_test();
+
+    std::string getRingName(const std::string &testName);
+};
+
+} // namespace Hanami
+} // namespace Kitsunemimi
+
+#endif // SHARED_MEMORY_RING_TEST_H
@@ -4,6 +4,7 @@ QT -= qt core gui
 CONFIG += c++17
 
 SUBDIRS = \
+    benchmark_tests \
     functional_tests
 
 tests.depends = src